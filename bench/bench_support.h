@@ -0,0 +1,445 @@
+#ifndef BENCH_SUPPORT_H
+#define BENCH_SUPPORT_H
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "concurrent_fifo_buffer.h"
+#include "lockfree_fifo_buffer.h"
+#include "multiwriter_fifo_buffer.h"
+#include "sharded_fifo_buffer.h"
+#include "stream_fifo_buffer.h"
+}
+
+namespace bench {
+
+struct cpu {
+    int id;
+    int core;
+    int package;
+    int node;
+};
+
+// NUMA node a CPU belongs to, from the nodeN link sysfs puts into its directory.
+inline int node_of_cpu(int cpu_id)
+{
+    const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu_id);
+    DIR *const directory = opendir(path.c_str());
+    if (directory == nullptr) {
+        return 0;
+    }
+
+    int node = 0;
+    while (const struct dirent *entry = readdir(directory)) {
+        const std::string name(entry->d_name);
+        if (name.rfind("node", 0) == 0 && name.size() > 4 && std::isdigit(static_cast<unsigned char>(name[4]))) {
+            node = std::stoi(name.substr(4));
+            break;
+        }
+    }
+    closedir(directory);
+    return node;
+}
+
+// NUMA nodes that have memory, parsed from the "0-1,3" list format of sysfs.
+inline std::vector<int> memory_nodes()
+{
+    std::ifstream file("/sys/devices/system/node/has_memory");
+    std::string list;
+    if (!std::getline(file, list)) {
+        return { 0 };
+    }
+
+    std::vector<int> nodes;
+    std::stringstream stream(list);
+    for (std::string range; std::getline(stream, range, ',');) {
+        const auto dash = range.find('-');
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int node = first; node <= last; node++) {
+            nodes.push_back(node);
+        }
+    }
+    return nodes;
+}
+
+// Logical CPUs this process may run on, with their physical core, package and NUMA node from sysfs.
+inline std::vector<cpu> online_cpus()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    const auto read_int = [] (const std::string &path) {
+        std::ifstream file(path);
+        int value = -1;
+        file >> value;
+        return value;
+    };
+
+    std::vector<cpu> cpus;
+    for (int id = 0; id < CPU_SETSIZE; id++) {
+        if (!CPU_ISSET(id, &allowed)) {
+            continue;
+        }
+        const std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+        cpus.push_back({ id, read_int(topology + "core_id"), read_int(topology + "physical_package_id"), node_of_cpu(id) });
+    }
+    return cpus;
+}
+
+inline bool pin_current_thread(int cpu_id)
+{
+    if (cpu_id < 0) {
+        return true;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu_id, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// How the producer and consumer threads are placed relative to the consumer's CPU.
+enum class layout {
+    none,   // not pinned, scheduler decides
+    smt,    // SMT siblings of the same physical core
+    core,   // different physical cores of the same package
+    socket, // different packages
+};
+
+inline const char *to_string(layout value)
+{
+    switch (value) {
+    case layout::none: return "none";
+    case layout::smt: return "smt";
+    case layout::core: return "core";
+    case layout::socket: return "socket";
+    }
+    return "unknown";
+}
+
+inline std::optional<layout> parse_layout(const std::string &name)
+{
+    for (auto value: { layout::none, layout::smt, layout::core, layout::socket }) {
+        if (name == to_string(value)) {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+// Picks the consumer CPU followed by producers CPUs for the given layout, or nothing if
+// the machine has no such pair. With layout::none every entry is -1 (unpinned).
+inline std::optional<std::vector<int>> place_threads(layout value, std::size_t producers)
+{
+    if (value == layout::none) {
+        return std::vector<int>(producers + 1, -1);
+    }
+
+    const auto cpus = online_cpus();
+    for (const auto &consumer: cpus) {
+        std::vector<int> placement { consumer.id };
+        for (const auto &candidate: cpus) {
+            if (candidate.id == consumer.id) {
+                continue;
+            }
+            const bool same_package = candidate.package == consumer.package;
+            const bool same_core = same_package && candidate.core == consumer.core;
+            if ((value == layout::smt && same_core) ||
+                (value == layout::core && same_package && !same_core) ||
+                (value == layout::socket && !same_package)) {
+                placement.push_back(candidate.id);
+            }
+        }
+        if (placement.size() > 1) {
+            // more producers than matching CPUs share them round-robin
+            std::vector<int> result { consumer.id };
+            for (std::size_t i = 0; i < producers; i++) {
+                result.push_back(placement.at(1 + i % (placement.size() - 1)));
+            }
+            return result;
+        }
+    }
+    return std::nullopt;
+}
+
+// Where the ring memory lives relative to the consumer's NUMA node.
+enum class numa {
+    none,   // first touch, no binding
+    local,  // bound to the consumer's node
+    remote, // bound to another node that has memory
+};
+
+inline const char *to_string(numa value)
+{
+    switch (value) {
+    case numa::none: return "none";
+    case numa::local: return "local";
+    case numa::remote: return "remote";
+    }
+    return "unknown";
+}
+
+inline std::optional<numa> parse_numa(const std::string &name)
+{
+    for (auto value: { numa::none, numa::local, numa::remote }) {
+        if (name == to_string(value)) {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+// Node to bind the ring to for a consumer on consumer_cpu (-1 when unpinned), -1 for
+// numa::none, or nothing if the machine has no remote node.
+inline std::optional<int> numa_node_for(numa value, int consumer_cpu)
+{
+    if (value == numa::none) {
+        return -1;
+    }
+
+    const int consumer_node = node_of_cpu(consumer_cpu >= 0 ? consumer_cpu : sched_getcpu());
+    if (value == numa::local) {
+        return consumer_node;
+    }
+    for (const int node: memory_nodes()) {
+        if (node != consumer_node) {
+            return node;
+        }
+    }
+    return std::nullopt;
+}
+
+struct implementation {
+    const char *name;
+    bool multiple_producers;
+    // producers is how many threads will enqueue, for implementations that size per producer
+    std::function<struct fifo_buffer *(std::size_t element_size, std::size_t count, std::size_t producers)> create;
+    // binds storage to a NUMA node; empty for implementations without placement control
+    std::function<struct fifo_buffer *(std::size_t element_size, std::size_t count, int node)> create_on_node;
+    // hands each producer thread its own handle to enqueue through; empty when
+    // producers share the buffer
+    std::function<struct fifo_buffer *(struct fifo_buffer *buffer)> producer;
+};
+
+inline std::vector<implementation> implementations()
+{
+    return {
+        { "lockfree", false, [] (std::size_t element_size, std::size_t count, std::size_t) {
+            return reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(element_size, count));
+        }, [] (std::size_t element_size, std::size_t count, int node) {
+            const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_NODE, node };
+            return reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new_with_options(element_size, count, &options));
+        } },
+        { "multiwriter_mutex", true, [] (std::size_t element_size, std::size_t count, std::size_t) {
+            return reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(element_size, count, MULTIWRITER_FIFO_BUFFER_MUTEX));
+        } },
+        { "multiwriter_lockfree", true, [] (std::size_t element_size, std::size_t count, std::size_t) {
+            return reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(element_size, count, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+        } },
+        { "multiwriter_combining", true, [] (std::size_t element_size, std::size_t count, std::size_t) {
+            return reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(element_size, count, MULTIWRITER_FIFO_BUFFER_COMBINING));
+        } },
+        { "sharded", true, [] (std::size_t element_size, std::size_t count, std::size_t producers) {
+            // a shard per producer, splitting the requested capacity so totals match the other rings
+            const std::size_t shards = std::max<std::size_t>(1, producers);
+            const std::size_t per_shard = std::max<std::size_t>(1, (count + shards - 1) / shards);
+            return reinterpret_cast<struct fifo_buffer *>(sharded_fifo_buffer_new(element_size, per_shard, shards));
+        }, {}, [] (struct fifo_buffer *buffer) {
+            // more producers than shards share the mutex-guarded one
+            struct fifo_buffer *const handle = sharded_fifo_buffer_register(buffer);
+            return handle != nullptr ? handle : buffer;
+        } },
+        { "concurrent", true, [] (std::size_t element_size, std::size_t count, std::size_t) {
+            return reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(element_size, count));
+        } },
+        { "stream", false, [] (std::size_t element_size, std::size_t count, std::size_t) {
+            // room for count records of element_size bytes plus their size headers
+            return reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(count * (element_size + 2 * alignof(std::max_align_t))));
+        } },
+    };
+}
+
+// Cycle counter on x86, CLOCK_MONOTONIC_RAW elsewhere; calibrate() measures how many
+// nanoseconds a tick is worth against CLOCK_MONOTONIC_RAW.
+class tick_clock {
+private:
+    double nanoseconds_per_tick_ = 1.0;
+
+    static std::uint64_t raw_nanoseconds()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+        return static_cast<std::uint64_t>(now.tv_sec) * 1000000000U + static_cast<std::uint64_t>(now.tv_nsec);
+    }
+public:
+    static const char *source()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return "rdtsc";
+#else
+        return "clock_monotonic_raw";
+#endif
+    }
+
+    static std::uint64_t now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return raw_nanoseconds();
+#endif
+    }
+
+    void calibrate(std::chrono::milliseconds duration)
+    {
+        const std::uint64_t start_ns = raw_nanoseconds();
+        const std::uint64_t start_ticks = now();
+        std::this_thread::sleep_for(duration);
+        const std::uint64_t ticks = now() - start_ticks;
+        const std::uint64_t ns = raw_nanoseconds() - start_ns;
+        nanoseconds_per_tick_ = ticks == 0 ? 1.0 : static_cast<double>(ns) / static_cast<double>(ticks);
+    }
+
+    [[nodiscard]] double nanoseconds_per_tick() const { return nanoseconds_per_tick_; }
+
+    [[nodiscard]] std::uint64_t to_nanoseconds(std::uint64_t ticks) const
+    {
+        return static_cast<std::uint64_t>(static_cast<double>(ticks) * nanoseconds_per_tick_);
+    }
+};
+
+// Log-linear histogram: every power of two is split into 2^sub_bucket_bits equal
+// buckets, so a recorded value is never off by more than ~3% and recording is a few
+// shifts and an increment.
+class histogram {
+private:
+    static constexpr unsigned sub_bucket_bits = 5;
+    static constexpr std::uint64_t sub_buckets = std::uint64_t { 1 } << sub_bucket_bits;
+
+    std::array<std::uint64_t, 64 * sub_buckets> counts_ {};
+    std::uint64_t total_ = 0;
+    std::uint64_t max_ = 0;
+
+    static std::size_t index_of(std::uint64_t value)
+    {
+        if (value < sub_buckets) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned shift = 63U - static_cast<unsigned>(__builtin_clzll(value)) - sub_bucket_bits;
+        return static_cast<std::size_t>((shift + 1) * sub_buckets + ((value >> shift) - sub_buckets));
+    }
+
+    // largest value that lands in the bucket
+    static std::uint64_t upper_bound_of(std::size_t index)
+    {
+        if (index < sub_buckets) {
+            return index;
+        }
+        const std::uint64_t shift = index / sub_buckets - 1;
+        const std::uint64_t lower = ((index % sub_buckets) + sub_buckets) << shift;
+        return lower + (std::uint64_t { 1 } << shift) - 1;
+    }
+public:
+    void record(std::uint64_t value)
+    {
+        counts_[index_of(value)]++;
+        total_++;
+        max_ = std::max(max_, value);
+    }
+
+    [[nodiscard]] std::uint64_t total() const { return total_; }
+    [[nodiscard]] std::uint64_t max() const { return max_; }
+
+    [[nodiscard]] std::uint64_t percentile(double percent) const
+    {
+        const auto wanted = static_cast<std::uint64_t>(static_cast<double>(total_) * percent / 100.0 + 0.5);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); i++) {
+            seen += counts_[i];
+            if (seen >= std::max<std::uint64_t>(wanted, 1)) {
+                return std::min(upper_bound_of(i), max_);
+            }
+        }
+        return max_;
+    }
+};
+
+// Minimal "--key=value" command line parser; values of repeated keys are comma separated.
+class options {
+private:
+    std::map<std::string, std::string> values_;
+public:
+    options(int argc, char **argv)
+    {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg(argv[i]);
+            if (arg.rfind("--", 0) != 0) {
+                continue;
+            }
+            const auto eq = arg.find('=');
+            values_[arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2)] = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        }
+    }
+
+    [[nodiscard]] bool has(const std::string &key) const { return values_.count(key) != 0; }
+
+    [[nodiscard]] std::vector<std::string> strings(const std::string &key, const std::vector<std::string> &fallback) const
+    {
+        const auto found = values_.find(key);
+        if (found == values_.end()) {
+            return fallback;
+        }
+        std::vector<std::string> result;
+        std::stringstream stream(found->second);
+        for (std::string item; std::getline(stream, item, ',');) {
+            result.push_back(item);
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::vector<std::size_t> sizes(const std::string &key, const std::vector<std::size_t> &fallback) const
+    {
+        if (!has(key)) {
+            return fallback;
+        }
+        std::vector<std::size_t> result;
+        for (const auto &item: strings(key, {})) {
+            result.push_back(std::stoull(item));
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::size_t size(const std::string &key, std::size_t fallback) const
+    {
+        return has(key) ? sizes(key, {}).at(0) : fallback;
+    }
+};
+
+} // namespace bench
+
+#endif // BENCH_SUPPORT_H
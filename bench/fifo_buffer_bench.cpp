@@ -0,0 +1,200 @@
+// Throughput sweep over every fifo_buffer implementation.
+//
+// Usage: fifo_buffer_bench [--implementations=lockfree,...] [--sizes=8,64,...]
+//                          [--capacities=64,1024,...] [--producers=N]
+//                          [--layouts=none,smt,core,socket] [--duration-ms=N]
+//                          [--max-ring-bytes=N] [--numa=none,local,remote]
+//
+// --numa=local,remote binds the ring of implementations that support it to the
+// consumer's NUMA node or to another one, to show the cost of remote ring memory.
+//
+// Results are written to stdout as a single JSON document.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "bench_support.h"
+
+namespace {
+
+struct result {
+    const char *implementation;
+    std::size_t element_size;
+    std::size_t capacity;
+    std::size_t producers;
+    bench::layout layout;
+    bench::numa numa;
+    std::uint64_t messages;
+    double seconds;
+};
+
+void *copy_bytes(void *destination, const void *source, std::size_t size)
+{
+    return std::memcpy(destination, source, size);
+}
+
+// Nothing when the ring cannot be created, e.g. out of memory or no memory on node.
+std::optional<result> run(const bench::implementation &implementation, std::size_t element_size, std::size_t capacity,
+           const std::vector<int> &placement, bench::layout layout, bench::numa numa, int node,
+           std::chrono::milliseconds duration)
+{
+    // the consumer creates the ring, so first-touch pages land on its node
+    bench::pin_current_thread(placement.at(0));
+    const std::size_t producers = placement.size() - 1;
+    struct fifo_buffer *buffer = node < 0 ? implementation.create(element_size, capacity, producers)
+                                          : implementation.create_on_node(element_size, capacity, node);
+    if (buffer == nullptr) {
+        bench::pin_current_thread(-1);
+        return std::nullopt;
+    }
+
+    std::atomic<bool> start { false };
+    std::atomic<bool> stop { false };
+    std::atomic<std::size_t> running { producers };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < producers; i++) {
+        threads.emplace_back([&, cpu = placement.at(i + 1)] {
+            bench::pin_current_thread(cpu);
+            struct fifo_buffer *const target = implementation.producer ? implementation.producer(buffer) : buffer;
+            std::vector<std::uint8_t> element(element_size, 0xa5);
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!target->vptr->enqueue(target, element.data(), element_size, copy_bytes)) {
+                    std::this_thread::yield();
+                }
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    std::vector<std::uint8_t> element(element_size);
+    std::uint64_t messages = 0;
+
+    const auto begin = std::chrono::steady_clock::now();
+    const auto end = begin + duration;
+    start.store(true, std::memory_order_release);
+    for (;;) {
+        if (buffer->vptr->dequeue(buffer, element.data(), copy_bytes)) {
+            // only look at the clock every 1024 messages while data keeps flowing
+            if ((++messages & 0x3ff) != 0) {
+                continue;
+            }
+        } else {
+            std::this_thread::yield();
+        }
+        if (std::chrono::steady_clock::now() >= end) {
+            break;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    stop.store(true, std::memory_order_relaxed);
+    while (running.load(std::memory_order_acquire) != 0) {
+        buffer->vptr->dequeue(buffer, element.data(), copy_bytes);
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    buffer->vptr->free(buffer);
+    bench::pin_current_thread(-1);
+
+    return result { implementation.name, element_size, capacity, producers, layout, numa, messages, seconds };
+}
+
+void print(const result &value, bool first)
+{
+    const double ops = static_cast<double>(value.messages) / value.seconds;
+    std::printf("%s\n    {\"implementation\": \"%s\", \"element_size\": %zu, \"capacity\": %zu, "
+                "\"producers\": %zu, \"layout\": \"%s\", \"numa\": \"%s\", \"messages\": %llu, \"seconds\": %.6f, "
+                "\"ops_per_second\": %.1f, \"bytes_per_second\": %.1f}",
+                first ? "" : ",", value.implementation, value.element_size, value.capacity,
+                value.producers, bench::to_string(value.layout), bench::to_string(value.numa),
+                static_cast<unsigned long long>(value.messages), value.seconds,
+                ops, ops * static_cast<double>(value.element_size));
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const bench::options options(argc, argv);
+
+    const auto names = options.strings("implementations", {});
+    const auto sizes = options.sizes("sizes", { 8, 64, 512, 4096, 65536 });
+    const auto capacities = options.sizes("capacities", { 64, 1024, 16384 });
+    const auto max_producers = options.size("producers", std::max(1U, std::thread::hardware_concurrency() - 1));
+    const auto layouts = options.strings("layouts", { "none", "smt", "core", "socket" });
+    const auto duration = std::chrono::milliseconds(options.size("duration-ms", 200));
+    const auto max_ring_bytes = options.size("max-ring-bytes", std::size_t { 256 } << 20);
+    std::vector<bench::numa> placements;
+    for (const auto &numa_name: options.strings("numa", { "none" })) {
+        const auto numa = bench::parse_numa(numa_name);
+        if (!numa) {
+            std::fprintf(stderr, "unknown numa placement '%s'\n", numa_name.c_str());
+            return 1;
+        }
+        placements.push_back(*numa);
+    }
+
+    std::printf("{\n  \"benchmark\": \"fifo_buffer_bench\",\n  \"duration_ms\": %lld,\n  \"results\": [",
+                static_cast<long long>(duration.count()));
+
+    bool first = true;
+    for (const auto &implementation: bench::implementations()) {
+        if (!names.empty() && std::find(names.begin(), names.end(), implementation.name) == names.end()) {
+            continue;
+        }
+        for (const auto &layout_name: layouts) {
+            const auto layout = bench::parse_layout(layout_name);
+            if (!layout) {
+                std::fprintf(stderr, "unknown layout '%s'\n", layout_name.c_str());
+                return 1;
+            }
+            const std::size_t producer_limit = implementation.multiple_producers ? max_producers : 1;
+            for (std::size_t producers = 1; producers <= producer_limit; producers++) {
+                const auto placement = bench::place_threads(*layout, producers);
+                if (!placement) {
+                    // topology has no CPU pair for this layout
+                    break;
+                }
+                for (const auto numa: placements) {
+                    const auto node = bench::numa_node_for(numa, placement->at(0));
+                    if (!node || (*node >= 0 && !implementation.create_on_node)) {
+                        // single node machine or no placement control
+                        continue;
+                    }
+                    for (const auto element_size: sizes) {
+                        for (const auto capacity: capacities) {
+                            if (element_size * capacity > max_ring_bytes) {
+                                continue;
+                            }
+                            const auto measured = run(implementation, element_size, capacity, *placement, *layout, numa, *node, duration);
+                            if (!measured) {
+                                std::fprintf(stderr, "skipped %s, element size %zu, capacity %zu, %zu producers, numa %s: "
+                                             "buffer could not be created\n", implementation.name, element_size, capacity,
+                                             producers, bench::to_string(numa));
+                                continue;
+                            }
+                            print(*measured, first);
+                            first = false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Round-trip latency between two threads bouncing a timestamp through a pair of queues.
+//
+// Usage: fifo_buffer_latency_bench [--implementations=lockfree,...] [--sizes=16,64,...]
+//                                  [--capacity=N] [--round-trips=N] [--contenders=0,2,...]
+//                                  [--layout=none|smt|core|socket]
+//
+// The pinger stamps a message, the echo thread sends it straight back and the pinger
+// records now - stamp. With contenders > 0 (multi-producer buffers only) that many
+// extra threads flood the forward queue with filler the echo thread discards, so
+// the measured round trip includes the cost of fighting over the producer side.
+// Results are written to stdout as a single JSON document, in nanoseconds.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "bench_support.h"
+
+namespace {
+
+struct message_header {
+    std::uint64_t stamp;
+    std::uint64_t filler;
+};
+
+void *copy_bytes(void *destination, const void *source, std::size_t size)
+{
+    return std::memcpy(destination, source, size);
+}
+
+// Busy-polls first and only starts yielding once the other side looks descheduled.
+template<typename Attempt>
+void spin_until(Attempt attempt)
+{
+    for (unsigned spins = 0; !attempt(); spins++) {
+        if (spins >= 1024) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Nothing when a ring cannot be created.
+std::optional<bench::histogram> run(const bench::implementation &implementation, const bench::tick_clock &clock,
+                     std::size_t element_size, std::size_t capacity, std::size_t round_trips,
+                     const std::vector<int> &placement)
+{
+    const std::size_t contenders = placement.size() - 2;
+    // the timing thread and every contender enqueue forward, only the echo thread backward
+    struct fifo_buffer *forward = implementation.create(element_size, capacity, contenders + 1);
+    struct fifo_buffer *backward = implementation.create(element_size, capacity, 1);
+    if (forward == nullptr || backward == nullptr) {
+        if (forward != nullptr) {
+            forward->vptr->free(forward);
+        }
+        if (backward != nullptr) {
+            backward->vptr->free(backward);
+        }
+        return std::nullopt;
+    }
+
+    std::atomic<bool> stop { false };
+    std::vector<std::thread> threads;
+
+    threads.emplace_back([&, cpu = placement.at(1)] {
+        bench::pin_current_thread(cpu);
+        std::vector<std::uint8_t> element(element_size);
+        message_header header;
+        for (std::size_t i = 0; i < round_trips;) {
+            spin_until([&] { return forward->vptr->dequeue(forward, element.data(), copy_bytes); });
+            std::memcpy(&header, element.data(), sizeof(header));
+            if (header.filler != 0) {
+                continue;
+            }
+            spin_until([&] { return backward->vptr->enqueue(backward, element.data(), element_size, copy_bytes); });
+            i++;
+        }
+    });
+    for (std::size_t i = 0; i < contenders; i++) {
+        threads.emplace_back([&, cpu = placement.at(i + 2)] {
+            bench::pin_current_thread(cpu);
+            std::vector<std::uint8_t> element(element_size);
+            const message_header header { 0, 1 };
+            std::memcpy(element.data(), &header, sizeof(header));
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!forward->vptr->enqueue(forward, element.data(), element_size, copy_bytes)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    bench::pin_current_thread(placement.at(0));
+    bench::histogram result;
+    std::vector<std::uint8_t> element(element_size);
+    for (std::size_t i = 0; i < round_trips; i++) {
+        const message_header header { bench::tick_clock::now(), 0 };
+        std::memcpy(element.data(), &header, sizeof(header));
+        spin_until([&] { return forward->vptr->enqueue(forward, element.data(), element_size, copy_bytes); });
+        spin_until([&] { return backward->vptr->dequeue(backward, element.data(), copy_bytes); });
+        message_header echoed;
+        std::memcpy(&echoed, element.data(), sizeof(echoed));
+        result.record(clock.to_nanoseconds(bench::tick_clock::now() - echoed.stamp));
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    forward->vptr->free(forward);
+    backward->vptr->free(backward);
+    bench::pin_current_thread(-1);
+
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const bench::options options(argc, argv);
+
+    const auto names = options.strings("implementations", {});
+    const auto sizes = options.sizes("sizes", { 16, 64, 512, 4096, 65536 });
+    const auto capacity = options.size("capacity", 1024);
+    const auto round_trips = options.size("round-trips", 100000);
+    const auto contention = options.sizes("contenders", { 0, 2 });
+    const auto layout_name = options.strings("layout", { "none" }).at(0);
+
+    const auto layout = bench::parse_layout(layout_name);
+    if (!layout) {
+        std::fprintf(stderr, "unknown layout '%s'\n", layout_name.c_str());
+        return 1;
+    }
+
+    bench::tick_clock clock;
+    clock.calibrate(std::chrono::milliseconds(100));
+
+    std::printf("{\n  \"benchmark\": \"fifo_buffer_latency_bench\",\n  \"clock\": \"%s\",\n"
+                "  \"nanoseconds_per_tick\": %.6f,\n  \"layout\": \"%s\",\n  \"results\": [",
+                bench::tick_clock::source(), clock.nanoseconds_per_tick(), bench::to_string(*layout));
+
+    bool first = true;
+    for (const auto &implementation: bench::implementations()) {
+        if (!names.empty() && std::find(names.begin(), names.end(), implementation.name) == names.end()) {
+            continue;
+        }
+        for (const auto contenders: contention) {
+            if (contenders != 0 && !implementation.multiple_producers) {
+                continue;
+            }
+            const auto placement = bench::place_threads(*layout, 1 + contenders);
+            if (!placement) {
+                std::fprintf(stderr, "no CPUs match layout '%s'\n", layout_name.c_str());
+                return 1;
+            }
+            for (auto element_size: sizes) {
+                element_size = std::max(element_size, sizeof(message_header));
+                const auto measured = run(implementation, clock, element_size, capacity, round_trips, *placement);
+                if (!measured) {
+                    std::fprintf(stderr, "skipped %s, element size %zu, capacity %zu: buffer could not be created\n",
+                                 implementation.name, element_size, capacity);
+                    continue;
+                }
+                const auto &latency = *measured;
+                std::printf("%s\n    {\"implementation\": \"%s\", \"element_size\": %zu, \"capacity\": %zu, "
+                            "\"contenders\": %zu, \"round_trips\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+                            "\"p99_9_ns\": %llu, \"max_ns\": %llu}",
+                            first ? "" : ",", implementation.name, element_size, capacity, contenders,
+                            static_cast<unsigned long long>(latency.total()),
+                            static_cast<unsigned long long>(latency.percentile(50.0)),
+                            static_cast<unsigned long long>(latency.percentile(99.0)),
+                            static_cast<unsigned long long>(latency.percentile(99.9)),
+                            static_cast<unsigned long long>(latency.max()));
+                std::fflush(stdout);
+                first = false;
+            }
+        }
+    }
+
+    std::printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,54 @@
+#ifndef BROADCAST_FIFO_BUFFER_H
+#define BROADCAST_FIFO_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "fifo_buffer_stats.h"
+
+// Single-producer ring where every registered consumer sees every element, each through
+// its own read cursor (Disruptor-style), so an element is copied in once however many
+// consumers read it. The producer waits for the slowest registered consumer; with no
+// consumers registered it never waits and elements are dropped.
+//
+// Consumers register and unregister at any time from their own thread. A new consumer
+// starts at the elements enqueued after it registered. Each consumer handle follows the
+// single-consumer rule on its own; different handles may be used concurrently.
+struct broadcast_fifo_buffer;
+struct broadcast_fifo_buffer_consumer;
+
+// At most max_consumers may be registered at once.
+struct broadcast_fifo_buffer *broadcast_fifo_buffer_new(size_t element_size, size_t count, size_t max_consumers);
+// Every consumer must have unregistered.
+void broadcast_fifo_buffer_delete(struct broadcast_fifo_buffer *self);
+size_t broadcast_fifo_buffer_capacity(const struct broadcast_fifo_buffer *self);
+
+// Producer side. Enqueueing fails while the slowest consumer is capacity elements behind.
+bool broadcast_fifo_buffer_enqueue_default(struct broadcast_fifo_buffer *self, const void *element, size_t size);
+bool broadcast_fifo_buffer_enqueue(struct broadcast_fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+void *broadcast_fifo_buffer_reserve(struct broadcast_fifo_buffer *self);
+void broadcast_fifo_buffer_commit(struct broadcast_fifo_buffer *self, size_t size);
+bool broadcast_fifo_buffer_is_full(struct broadcast_fifo_buffer *self);
+
+// NULL when max_consumers are already registered.
+struct broadcast_fifo_buffer_consumer *broadcast_fifo_buffer_register(struct broadcast_fifo_buffer *self);
+// The handle must not be used afterwards; the producer stops waiting for it.
+void broadcast_fifo_buffer_unregister(struct broadcast_fifo_buffer_consumer *consumer);
+
+// Consumer side, zero-copy as in lockfree_fifo_buffer: acquire returns the next slot
+// for this consumer (NULL when it has read everything), acquire_n up to count of them,
+// and release hands the given number of acquired slots back to the producer.
+const void *broadcast_fifo_buffer_acquire(struct broadcast_fifo_buffer_consumer *consumer, size_t *size);
+size_t broadcast_fifo_buffer_acquire_n(struct broadcast_fifo_buffer_consumer *consumer, const void **elements, size_t *sizes, size_t count);
+void broadcast_fifo_buffer_release(struct broadcast_fifo_buffer_consumer *consumer, size_t count);
+// Copying variants; element may be NULL to skip one.
+bool broadcast_fifo_buffer_dequeue_default(struct broadcast_fifo_buffer_consumer *consumer, void *element);
+bool broadcast_fifo_buffer_dequeue(struct broadcast_fifo_buffer_consumer *consumer, void *element, void *(*copy)(void *, const void *, size_t));
+// Elements this consumer has yet to read.
+size_t broadcast_fifo_buffer_count(const struct broadcast_fifo_buffer_consumer *consumer);
+bool broadcast_fifo_buffer_is_empty(const struct broadcast_fifo_buffer_consumer *consumer);
+// Producer counters together with this consumer's, high_water_mark being the longest
+// backlog it saw; false without FIFO_BUFFER_STATS.
+bool broadcast_fifo_buffer_stats_snapshot(const struct broadcast_fifo_buffer_consumer *consumer, struct fifo_buffer_stats *stats);
+
+#endif // BROADCAST_FIFO_BUFFER_H
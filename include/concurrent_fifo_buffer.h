@@ -0,0 +1,28 @@
+#ifndef CONCURRENT_FIFO_BUFFER_H
+#define CONCURRENT_FIFO_BUFFER_H
+
+#include "fifo_buffer.h"
+#include "multiwriter_fifo_buffer.h"
+
+struct concurrent_fifo_buffer;
+
+#define CONCURRENT_FIFO_BUFFER_INTERFACE_METHODS \
+    MULTIWRITER_FIFO_BUFFER_INTERFACE_METHODS;       \
+    bool (*try_dequeue_default)(struct fifo_buffer *self, void *element); \
+    bool (*try_dequeue)(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t))
+
+union concurrent_fifo_buffer_interface {
+    struct fifo_buffer_interface parent;
+    struct {
+        CONCURRENT_FIFO_BUFFER_INTERFACE_METHODS;
+    };
+};
+
+struct concurrent_fifo_buffer {
+    const union concurrent_fifo_buffer_interface *vptr;
+};
+
+struct concurrent_fifo_buffer *concurrent_fifo_buffer_new(size_t element_size, size_t count);
+void concurrent_fifo_buffer_delete(struct fifo_buffer *self);
+
+#endif // CONCURRENT_FIFO_BUFFER_H
@@ -8,7 +8,11 @@
 struct fifo_buffer_interface;
 struct fifo_buffer;
 struct fifo_buffer_element;
+struct fifo_buffer_stats;
 
+// enqueue_bulk and dequeue_bulk move up to count elements laid out size bytes apart and
+// return how many moved. dequeue_bulk copies at most size bytes per element, truncating
+// larger ones, so it never writes past elements + count * size.
 #define FIFO_BUFFER_INTERFACE_METHODS \
 void (*dispose)(struct fifo_buffer *self); \
 void (*free)(struct fifo_buffer *self); \
@@ -18,10 +22,13 @@ bool (*enqueue_default)(struct fifo_buffer *self, const void *element, size_t si
 bool (*enqueue)(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t)); \
 bool (*dequeue_default)(struct fifo_buffer *self, void *element); \
 bool (*dequeue)(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t)); \
+size_t (*enqueue_bulk)(struct fifo_buffer *self, const void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t)); \
+size_t (*dequeue_bulk)(struct fifo_buffer *self, void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t)); \
 const void *(*peek)(const struct fifo_buffer *self); \
 size_t (*peek_size)(const struct fifo_buffer *self); \
 bool (*is_empty)(const struct fifo_buffer *self); \
-bool (*is_full)(const struct fifo_buffer *self)
+bool (*is_full)(const struct fifo_buffer *self); \
+bool (*stats_snapshot)(const struct fifo_buffer *self, struct fifo_buffer_stats *stats)
 
 struct fifo_buffer_interface {
     FIFO_BUFFER_INTERFACE_METHODS;
@@ -0,0 +1,41 @@
+#ifndef FIFO_BUFFER_MERGE_H
+#define FIFO_BUFFER_MERGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fifo_buffer.h"
+
+// Consumer merging several fifo_buffers, each already ordered by a key such as a
+// timestamp, into one stream in global key order. It peeks every input's head,
+// extracts its key with the user's function and keeps the inputs in a binary min-heap,
+// so each element costs O(log inputs) instead of buffering and sorting.
+//
+// An element is only emitted once no input can still produce a smaller key: every
+// input has a head queued, or the key is at most the watermark. The watermark is the
+// caller's promise that no input will ever produce a key below it (e.g. the current
+// time minus the largest input lag), and keeps idle inputs from stalling the others.
+//
+// The merge is the single consumer of all its inputs and is not thread safe itself.
+struct fifo_buffer_merge;
+
+typedef uint64_t (*fifo_buffer_merge_key)(const void *element, size_t size, void *context);
+
+// inputs is copied; the buffers must outlive the merge.
+struct fifo_buffer_merge *fifo_buffer_merge_new(struct fifo_buffer *const *inputs, size_t input_count, fifo_buffer_merge_key key, void *context);
+void fifo_buffer_merge_delete(struct fifo_buffer_merge *self);
+
+// Raises the watermark; lowering it is ignored.
+void fifo_buffer_merge_advance_watermark(struct fifo_buffer_merge *self, uint64_t watermark);
+uint64_t fifo_buffer_merge_watermark(const struct fifo_buffer_merge *self);
+
+// Next element in key order, or NULL when none can be emitted yet. input, when not
+// NULL, receives the index of the buffer it is queued in; it stays at that buffer's
+// head until dequeued.
+const void *fifo_buffer_merge_peek(struct fifo_buffer_merge *self, size_t *size, size_t *input);
+bool fifo_buffer_merge_dequeue_default(struct fifo_buffer_merge *self, void *element);
+bool fifo_buffer_merge_dequeue(struct fifo_buffer_merge *self, void *element, void *(*copy)(void *, const void *, size_t));
+size_t fifo_buffer_merge_dequeue_bulk(struct fifo_buffer_merge *self, void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+
+#endif // FIFO_BUFFER_MERGE_H
@@ -0,0 +1,63 @@
+#ifndef FIFO_BUFFER_STATS_H
+#define FIFO_BUFFER_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FIFO_BUFFER_STATS_SIZE_BUCKETS 16
+
+// Pages backing a buffer's slot storage.
+enum fifo_buffer_page_backing {
+    FIFO_BUFFER_PAGES_SMALL,
+    // madvise(MADV_HUGEPAGE) on a huge page aligned mapping; the kernel promotes it to
+    // huge pages as it sees fit
+    FIFO_BUFFER_PAGES_TRANSPARENT_HUGE,
+    // MAP_HUGETLB from the reserved huge page pool
+    FIFO_BUFFER_PAGES_HUGETLB,
+};
+
+// Counters accumulated since a buffer was created, as returned by stats_snapshot().
+// They are only collected when the library is built with FIFO_BUFFER_STATS defined
+// (cmake -DLOCKFREE_QUEUE_STATS=ON); otherwise stats_snapshot() returns false.
+struct fifo_buffer_stats {
+    uint64_t enqueued;
+    uint64_t dequeued;
+    // enqueue calls refused because the ring was full
+    uint64_t full_rejects;
+    // dequeue calls that found the ring empty
+    uint64_t empty_polls;
+    // try_enqueue calls that lost the race for the producer lock
+    uint64_t trylock_failures;
+    // elements a lossy consumer skipped because the producer overwrote them
+    uint64_t overwritten;
+    // most elements ever queued at once. It is sampled whenever a side re-reads the
+    // other's index, so it can miss a short peak between two samples but never counts
+    // elements that were already dequeued
+    size_t high_water_mark;
+    // size_histogram[i] counts messages of i significant bits (0, 1, 2-3, 4-7, ...),
+    // the last bucket also takes everything larger
+    uint64_t size_histogram[FIFO_BUFFER_STATS_SIZE_BUCKETS];
+    // pages actually obtained for the slot storage
+    enum fifo_buffer_page_backing page_backing;
+};
+
+#if defined(FIFO_BUFFER_STATS) && !defined(__cplusplus)
+#include <stdatomic.h>
+
+// Counter blocks embedded in each side of a buffer (see lockfree_fifo_buffer_inline.h).
+struct fifo_buffer_producer_stats {
+    atomic_uint_fast64_t enqueued;
+    atomic_uint_fast64_t full_rejects;
+    atomic_size_t high_water_mark;
+    atomic_uint_fast64_t size_histogram[FIFO_BUFFER_STATS_SIZE_BUCKETS];
+};
+
+struct fifo_buffer_consumer_stats {
+    atomic_uint_fast64_t dequeued;
+    atomic_uint_fast64_t empty_polls;
+    // backlog seen when the consumer refreshed its copy of the producer's index
+    atomic_size_t high_water_mark;
+};
+#endif
+
+#endif // FIFO_BUFFER_STATS_H
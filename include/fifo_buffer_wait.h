@@ -0,0 +1,34 @@
+#ifndef FIFO_BUFFER_WAIT_H
+#define FIFO_BUFFER_WAIT_H
+
+#include <stdatomic.h>
+
+// One direction a thread can block on ("not empty" or "not full").
+// epoch is the futex word; waiters counts threads that are about to park or parked,
+// so that the notifying side only enters the kernel when somebody is actually waiting.
+struct fifo_buffer_wait_point {
+    atomic_uint epoch;
+    atomic_uint waiters;
+};
+
+// Set once the process registered for expedited membarrier. Parking threads then issue
+// the process-wide barrier themselves, so the notifying side needs no fence of its own.
+extern atomic_bool fifo_buffer_wait_asymmetric_barrier;
+
+void fifo_buffer_wait_point_wake_all(struct fifo_buffer_wait_point *self);
+
+// Called by the opposite side right after it published progress.
+static inline void fifo_buffer_wait_point_notify(struct fifo_buffer_wait_point *const self)
+{
+    // orders the preceding index publication before the waiter check; pairs with the barrier in wait
+    if (atomic_load_explicit(&fifo_buffer_wait_asymmetric_barrier, memory_order_relaxed)) {
+        atomic_signal_fence(memory_order_seq_cst);
+    } else {
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+    if (atomic_load_explicit(&self->waiters, memory_order_relaxed) != 0) {
+        fifo_buffer_wait_point_wake_all(self);
+    }
+}
+
+#endif // FIFO_BUFFER_WAIT_H
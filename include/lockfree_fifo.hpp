@@ -0,0 +1,272 @@
+#ifndef LOCKFREE_FIFO_HPP
+#define LOCKFREE_FIFO_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Header-only typed counterparts of lockfree_fifo_buffer (fifo) and the lock-free
+// multiwriter strategy (mpsc_fifo). Elements of T are stored in place, so any movable
+// type can be queued, and Capacity is a compile-time power of two so masking folds
+// into constants.
+namespace lockfree_queue {
+
+inline constexpr std::size_t cache_line_size = 64;
+
+namespace detail {
+
+template<std::size_t Capacity>
+inline constexpr bool is_power_of_two = Capacity >= 2 && (Capacity & (Capacity - 1)) == 0;
+
+template<typename T>
+struct storage {
+    alignas(T) std::byte bytes[sizeof(T)];
+
+    T *get() noexcept { return std::launder(reinterpret_cast<T *>(bytes)); }
+};
+
+} // namespace detail
+
+// Single-producer/single-consumer ring with the lockfree_fifo_buffer index protocol:
+// free-running write/read counters whose difference is the number queued, so all
+// Capacity slots are usable, and each side caching the other's counter until the ring
+// looks full or empty.
+template<typename T, std::size_t Capacity>
+class fifo {
+    static_assert(detail::is_power_of_two<Capacity>, "Capacity must be a power of two");
+    static_assert(std::is_nothrow_destructible_v<T>, "T must be nothrow destructible");
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    alignas(cache_line_size) std::atomic<std::size_t> write_index_ { 0 };
+    std::size_t cached_read_index_ = 0;
+
+    alignas(cache_line_size) std::atomic<std::size_t> read_index_ { 0 };
+    std::size_t cached_write_index_ = 0;
+
+    alignas(cache_line_size) detail::storage<T> slots_[Capacity];
+public:
+    fifo() = default;
+    fifo(const fifo &) = delete;
+    fifo &operator=(const fifo &) = delete;
+
+    ~fifo()
+    {
+        const std::size_t write_index = write_index_.load(std::memory_order_acquire);
+        for (std::size_t i = read_index_.load(std::memory_order_relaxed); i != write_index; i++) {
+            slots_[i & mask].get()->~T();
+        }
+    }
+
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    template<typename... Args>
+    bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    {
+        const std::size_t current_index = write_index_.load(std::memory_order_relaxed);
+
+        if (current_index - cached_read_index_ >= Capacity) {
+            cached_read_index_ = read_index_.load(std::memory_order_acquire);
+            if (current_index - cached_read_index_ >= Capacity) {
+                return false;
+            }
+        }
+
+        // a throwing constructor leaves the slot unpublished
+        ::new (static_cast<void *>(slots_[current_index & mask].bytes)) T(std::forward<Args>(args)...);
+        write_index_.store(current_index + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(T &&value) noexcept(std::is_nothrow_move_constructible_v<T>) { return emplace(std::move(value)); }
+    bool try_push(const T &value) noexcept(std::is_nothrow_copy_constructible_v<T>) { return emplace(value); }
+
+    bool try_pop(T &value) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        T *const head = front();
+        if (head == nullptr) {
+            return false;
+        }
+
+        value = std::move(*head);
+        pop();
+        return true;
+    }
+
+    // Head element, or nullptr when empty. Consumer side only.
+    T *front() noexcept
+    {
+        const std::size_t current_index = read_index_.load(std::memory_order_relaxed);
+        if (current_index == cached_write_index_) {
+            cached_write_index_ = write_index_.load(std::memory_order_acquire);
+            if (current_index == cached_write_index_) {
+                return nullptr;
+            }
+        }
+
+        return slots_[current_index & mask].get();
+    }
+
+    // Destroys the head element; front() must have returned it.
+    void pop() noexcept
+    {
+        const std::size_t current_index = read_index_.load(std::memory_order_relaxed);
+        slots_[current_index & mask].get()->~T();
+        read_index_.store(current_index + 1, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return write_index_.load(std::memory_order_acquire) == read_index_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        const std::size_t read_index = read_index_.load(std::memory_order_acquire);
+        const std::size_t write_index = write_index_.load(std::memory_order_acquire);
+        return std::min(write_index - read_index, Capacity);
+    }
+};
+
+// Multi-producer/single-consumer ring with the sequenced_fifo_buffer protocol: every slot
+// carries a sequence number, producers claim a position by CAS and publish by bumping
+// the slot's sequence, so all Capacity slots are usable.
+template<typename T, std::size_t Capacity>
+class mpsc_fifo {
+    static_assert(detail::is_power_of_two<Capacity>, "Capacity must be a power of two");
+    static_assert(std::is_nothrow_destructible_v<T>, "T must be nothrow destructible");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "T must be nothrow move constructible");
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    struct slot {
+        std::atomic<std::size_t> sequence;
+        detail::storage<T> value;
+    };
+
+    alignas(cache_line_size) std::atomic<std::size_t> write_index_ { 0 };
+    alignas(cache_line_size) std::atomic<std::size_t> read_index_ { 0 };
+    alignas(cache_line_size) slot slots_[Capacity];
+
+    // claims the next position for a producer, or returns nullptr when full
+    slot *claim() noexcept
+    {
+        std::size_t position = write_index_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot &candidate = slots_[position & mask];
+            const std::size_t sequence = candidate.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+            if (difference == 0) {
+                if (write_index_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    return &candidate;
+                }
+            } else if (difference < 0) {
+                return nullptr;
+            } else {
+                position = write_index_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static void publish(slot &claimed) noexcept
+    {
+        claimed.sequence.store(claimed.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+public:
+    mpsc_fifo() noexcept
+    {
+        for (std::size_t i = 0; i < Capacity; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpsc_fifo(const mpsc_fifo &) = delete;
+    mpsc_fifo &operator=(const mpsc_fifo &) = delete;
+
+    ~mpsc_fifo()
+    {
+        while (front() != nullptr) {
+            pop();
+        }
+    }
+
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    template<typename... Args>
+    bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    {
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            slot *const claimed = claim();
+            if (claimed == nullptr) {
+                return false;
+            }
+            ::new (static_cast<void *>(claimed->value.bytes)) T(std::forward<Args>(args)...);
+            publish(*claimed);
+            return true;
+        } else {
+            // a claimed slot must be published, so build the element before claiming one
+            T value(std::forward<Args>(args)...);
+            return emplace(std::move(value));
+        }
+    }
+
+    bool try_push(T &&value) noexcept { return emplace(std::move(value)); }
+    bool try_push(const T &value) noexcept(std::is_nothrow_copy_constructible_v<T>) { return emplace(value); }
+
+    bool try_pop(T &value) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        T *const head = front();
+        if (head == nullptr) {
+            return false;
+        }
+
+        value = std::move(*head);
+        pop();
+        return true;
+    }
+
+    // Head element, or nullptr when empty or the next producer has not published yet.
+    // Consumer side only.
+    T *front() noexcept
+    {
+        const std::size_t position = read_index_.load(std::memory_order_relaxed);
+        slot &head = slots_[position & mask];
+        if (head.sequence.load(std::memory_order_acquire) != position + 1) {
+            return nullptr;
+        }
+
+        return head.value.get();
+    }
+
+    // Destroys the head element; front() must have returned it.
+    void pop() noexcept
+    {
+        const std::size_t position = read_index_.load(std::memory_order_relaxed);
+        slot &head = slots_[position & mask];
+        head.value.get()->~T();
+        head.sequence.store(position + Capacity, std::memory_order_release);
+        read_index_.store(position + 1, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        const std::size_t position = read_index_.load(std::memory_order_acquire);
+        return slots_[position & mask].sequence.load(std::memory_order_acquire) != position + 1;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        const std::size_t read_index = read_index_.load(std::memory_order_acquire);
+        const std::size_t write_index = write_index_.load(std::memory_order_acquire);
+        return write_index > read_index ? write_index - read_index : 0;
+    }
+};
+
+} // namespace lockfree_queue
+
+#endif // LOCKFREE_FIFO_HPP
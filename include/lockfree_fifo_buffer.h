@@ -1,13 +1,68 @@
 #ifndef LOCKFREE_FIFO_BUFFER_H
 #define LOCKFREE_FIFO_BUFFER_H
 
+#include <time.h>
+
 #include "fifo_buffer.h"
+#include "fifo_buffer_stats.h"
 
 struct lockfree_fifo_buffer;
 
+enum lockfree_fifo_buffer_numa_policy {
+    // storage pages land on the node of whichever thread touches them first
+    LOCKFREE_FIFO_BUFFER_NUMA_FIRST_TOUCH,
+    // storage is bound to numa_node
+    LOCKFREE_FIFO_BUFFER_NUMA_NODE,
+    // storage is bound to the node of the creating thread; create from the consumer
+    LOCKFREE_FIFO_BUFFER_NUMA_CURRENT_NODE,
+};
+
+struct lockfree_fifo_buffer_options {
+    enum lockfree_fifo_buffer_numa_policy numa_policy;
+    int numa_node;
+    // pages wanted for the slot storage; huge pages fall back to smaller ones when the
+    // system has none to give, see lockfree_fifo_buffer_page_backing()
+    enum fifo_buffer_page_backing pages;
+};
+
 bool lockfree_fifo_buffer_initialize(struct lockfree_fifo_buffer *self, size_t element_size, size_t count);
 struct lockfree_fifo_buffer *lockfree_fifo_buffer_new(size_t element_size, size_t count);
+// options may be NULL for the defaults. new_with_options places the buffer itself, which
+// holds the index cache lines, on the same node as the storage; initialize_with_options
+// only binds the storage and leaves self where the caller put it.
+bool lockfree_fifo_buffer_initialize_with_options(struct lockfree_fifo_buffer *self, size_t element_size, size_t count, const struct lockfree_fifo_buffer_options *options);
+struct lockfree_fifo_buffer *lockfree_fifo_buffer_new_with_options(size_t element_size, size_t count, const struct lockfree_fifo_buffer_options *options);
+// Node the storage is bound to, or -1 with LOCKFREE_FIFO_BUFFER_NUMA_FIRST_TOUCH.
+int lockfree_fifo_buffer_numa_node(const struct fifo_buffer *self);
+// Pages the storage actually got; also reported by stats_snapshot().
+enum fifo_buffer_page_backing lockfree_fifo_buffer_page_backing(const struct fifo_buffer *self);
 void lockfree_fifo_buffer_dispose(struct fifo_buffer *self);
 void lockfree_fifo_buffer_delete(struct fifo_buffer *self);
 
+// Producer-side zero-copy write: reserve returns the next free slot (NULL when full),
+// commit publishes it with the number of bytes actually written.
+void *lockfree_fifo_buffer_reserve(struct fifo_buffer *self);
+void lockfree_fifo_buffer_commit(struct fifo_buffer *self, size_t size);
+
+// Consumer-side zero-copy read: acquire returns the head slot (NULL when empty),
+// acquire_n fills up to count consecutive readable slots and returns how many,
+// release frees the given number of acquired slots back to the producer.
+const void *lockfree_fifo_buffer_acquire(struct fifo_buffer *self, size_t *size);
+size_t lockfree_fifo_buffer_acquire_n(struct fifo_buffer *self, const void **elements, size_t *sizes, size_t count);
+void lockfree_fifo_buffer_release(struct fifo_buffer *self, size_t count);
+
+// Blocking variants: spin for the spin budget, then park on a futex until the operation
+// succeeds, the buffer is closed or the deadline (absolute CLOCK_MONOTONIC) passes.
+// Enqueueing fails once closed; dequeueing still drains what was queued before close.
+// They dispatch through the vtable, so they also work for the mutex and combining multiwriter
+// strategies. Other buffers have no wait points: the wait functions return false at once
+// and close/set_spin_budget do nothing.
+bool lockfree_fifo_buffer_enqueue_wait(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+bool lockfree_fifo_buffer_enqueue_until(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t), const struct timespec *deadline);
+bool lockfree_fifo_buffer_dequeue_wait(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
+bool lockfree_fifo_buffer_dequeue_until(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t), const struct timespec *deadline);
+void lockfree_fifo_buffer_close(struct fifo_buffer *self);
+bool lockfree_fifo_buffer_is_closed(const struct fifo_buffer *self);
+void lockfree_fifo_buffer_set_spin_budget(struct fifo_buffer *self, unsigned spin_budget);
+
 #endif // LOCKFREE_FIFO_BUFFER_H
@@ -0,0 +1,143 @@
+#ifndef LOCKFREE_FIFO_BUFFER_INLINE_H
+#define LOCKFREE_FIFO_BUFFER_INLINE_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fifo_buffer.h"
+#include "fifo_buffer_stats.h"
+#include "fifo_buffer_wait.h"
+#include "lockfree_fifo_buffer.h"
+
+// Layout of struct lockfree_fifo_buffer plus static inline enqueue/dequeue/peek for
+// C11 callers that know they hold a lockfree_fifo_buffer, so the hot path can be
+// inlined into their loops instead of going through the vtable. The inline and the
+// out-of-line functions may be mixed freely on the same buffer, keeping the usual
+// single producer/single consumer rule. With FIFO_BUFFER_STATS the inline functions
+// forward to the vtable so that every operation is still counted.
+
+#define LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE 64
+
+struct lockfree_fifo_buffer_element {
+    size_t size;
+    alignas(max_align_t) uint8_t buffer[];
+};
+
+struct lockfree_fifo_buffer {
+    struct fifo_buffer parent;
+    size_t element_size;
+    size_t capacity;
+    size_t element_stride;
+    uint8_t *buffer;
+    unsigned spin_budget;
+    atomic_bool closed;
+    // node the storage is bound to, -1 when it was left to first touch
+    int numa_node;
+    enum fifo_buffer_page_backing page_backing;
+    // storage comes from fifo_buffer_memory_map rather than aligned_alloc
+    bool storage_mapped;
+    // self was mapped by lockfree_fifo_buffer_new_with_options rather than allocated
+    bool mapped;
+
+    // write_index and read_index count every element ever enqueued/dequeued; their
+    // difference is the number queued, so all capacity slots are usable. Wrapping
+    // around is harmless because capacity is a power of two.
+
+    // producer side: only the writer touches this line on the fast path
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t write_index;
+    size_t cached_read_index;
+    struct fifo_buffer_wait_point not_empty;
+#if defined(FIFO_BUFFER_STATS)
+    struct fifo_buffer_producer_stats producer_stats;
+#endif
+
+    // consumer side: only the reader touches this line on the fast path
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t read_index;
+    size_t cached_write_index;
+    struct fifo_buffer_wait_point not_full;
+#if defined(FIFO_BUFFER_STATS)
+    struct fifo_buffer_consumer_stats consumer_stats;
+#endif
+};
+
+// index is a free-running counter, masked down to its slot here
+static inline struct lockfree_fifo_buffer_element *lockfree_fifo_buffer_element_at(const struct lockfree_fifo_buffer *const self, const size_t index)
+{
+    return (struct lockfree_fifo_buffer_element *)(self->buffer + (index & (self->capacity - 1)) * self->element_stride);
+}
+
+// Same as enqueue_default() through the vtable.
+static inline bool lockfree_fifo_buffer_enqueue_inline(struct lockfree_fifo_buffer *const self, const void *const element, const size_t size)
+{
+#if defined(FIFO_BUFFER_STATS)
+    return self->parent.vptr->enqueue_default(&self->parent, element, size);
+#else
+    const size_t current_index = atomic_load_explicit(&self->write_index, memory_order_relaxed);
+
+    if (current_index - self->cached_read_index >= self->capacity) {
+        self->cached_read_index = atomic_load_explicit(&self->read_index, memory_order_acquire);
+        if (current_index - self->cached_read_index >= self->capacity) {
+            return false;
+        }
+    }
+
+    struct lockfree_fifo_buffer_element *const dest = lockfree_fifo_buffer_element_at(self, current_index);
+    memcpy(dest->buffer, element, size);
+    dest->size = size;
+
+    atomic_store_explicit(&self->write_index, current_index + 1, memory_order_release);
+
+    fifo_buffer_wait_point_notify(&self->not_empty);
+    return true;
+#endif
+}
+
+// Same as dequeue_default() through the vtable; element may be NULL to drop the head.
+static inline bool lockfree_fifo_buffer_dequeue_inline(struct lockfree_fifo_buffer *const self, void *const element)
+{
+#if defined(FIFO_BUFFER_STATS)
+    return self->parent.vptr->dequeue_default(&self->parent, element);
+#else
+    const size_t current_index = atomic_load_explicit(&self->read_index, memory_order_relaxed);
+    if (current_index == self->cached_write_index) {
+        self->cached_write_index = atomic_load_explicit(&self->write_index, memory_order_acquire);
+        if (current_index == self->cached_write_index) {
+            return false;
+        }
+    }
+
+    if (element != NULL) {
+        const struct lockfree_fifo_buffer_element *const src = lockfree_fifo_buffer_element_at(self, current_index);
+        memcpy(element, src->buffer, src->size);
+    }
+
+    atomic_store_explicit(&self->read_index, current_index + 1, memory_order_release);
+
+    fifo_buffer_wait_point_notify(&self->not_full);
+    return true;
+#endif
+}
+
+// Head element and its size (size may be NULL), or NULL when empty. Consumer side only.
+static inline const void *lockfree_fifo_buffer_peek_inline(struct lockfree_fifo_buffer *const self, size_t *const size)
+{
+    const size_t current_index = atomic_load_explicit(&self->read_index, memory_order_relaxed);
+    if (current_index == self->cached_write_index) {
+        self->cached_write_index = atomic_load_explicit(&self->write_index, memory_order_acquire);
+        if (current_index == self->cached_write_index) {
+            return NULL;
+        }
+    }
+
+    const struct lockfree_fifo_buffer_element *const head = lockfree_fifo_buffer_element_at(self, current_index);
+    if (size != NULL) {
+        *size = head->size;
+    }
+    return head->buffer;
+}
+
+#endif // LOCKFREE_FIFO_BUFFER_INLINE_H
@@ -0,0 +1,116 @@
+#ifndef LOCKFREE_FIFO_DEFINE_H
+#define LOCKFREE_FIFO_DEFINE_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Type-specialized single-producer/single-consumer queues for C11 code that cannot use
+// the C++ templates. DEFINE_LOCKFREE_FIFO(name, T, N) generates struct name holding N
+// elements of T in place (N a power of two) and static inline functions
+//
+//     void name##_initialize(struct name *self);
+//     bool name##_enqueue(struct name *self, const T *element);
+//     bool name##_dequeue(struct name *self, T *element);   // element may be NULL
+//     T *name##_peek(struct name *self);                    // consumer side, NULL when empty
+//     size_t name##_count(const struct name *self);
+//     bool name##_is_empty(const struct name *self);
+//     bool name##_is_full(const struct name *self);
+//     size_t name##_capacity(void);
+//
+// Elements are copied by assignment, there is no per-slot size header and no vtable,
+// and the index mask is a constant. The index protocol is that of lockfree_fifo_buffer:
+// free-running counters, so all N slots are usable.
+// The struct and the functions can also be generated separately, e.g. the struct in a
+// header and the functions next to their only user.
+
+#define LOCKFREE_FIFO_DEFINE_CACHE_LINE_SIZE 64
+
+#define DEFINE_LOCKFREE_FIFO_STRUCT(name, T, N)                                                 \
+    _Static_assert((N) >= 1 && ((N) & ((N) - 1)) == 0, #name ": capacity must be a power of two"); \
+    struct name {                                                                               \
+        alignas(LOCKFREE_FIFO_DEFINE_CACHE_LINE_SIZE) atomic_size_t write_index;                \
+        size_t cached_read_index;                                                               \
+        alignas(LOCKFREE_FIFO_DEFINE_CACHE_LINE_SIZE) atomic_size_t read_index;                 \
+        size_t cached_write_index;                                                              \
+        alignas(LOCKFREE_FIFO_DEFINE_CACHE_LINE_SIZE) T slots[N];                               \
+    }
+
+#define DEFINE_LOCKFREE_FIFO_FUNCTIONS(name, T, N)                                              \
+    static inline void name##_initialize(struct name *const self)                               \
+    {                                                                                           \
+        atomic_init(&self->write_index, 0);                                                     \
+        atomic_init(&self->read_index, 0);                                                      \
+        self->cached_read_index = 0;                                                            \
+        self->cached_write_index = 0;                                                           \
+    }                                                                                           \
+                                                                                                \
+    static inline size_t name##_capacity(void)                                                  \
+    {                                                                                           \
+        return (N);                                                                             \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_enqueue(struct name *const self, const T *const element)         \
+    {                                                                                           \
+        const size_t current_index = atomic_load_explicit(&self->write_index, memory_order_relaxed); \
+        if (current_index - self->cached_read_index >= (N)) {                                   \
+            self->cached_read_index = atomic_load_explicit(&self->read_index, memory_order_acquire); \
+            if (current_index - self->cached_read_index >= (N)) {                               \
+                return false;                                                                   \
+            }                                                                                   \
+        }                                                                                       \
+        self->slots[current_index & ((N) - 1)] = *element;                                      \
+        atomic_store_explicit(&self->write_index, current_index + 1, memory_order_release);     \
+        return true;                                                                            \
+    }                                                                                           \
+                                                                                                \
+    static inline T *name##_peek(struct name *const self)                                       \
+    {                                                                                           \
+        const size_t current_index = atomic_load_explicit(&self->read_index, memory_order_relaxed); \
+        if (current_index == self->cached_write_index) {                                        \
+            self->cached_write_index = atomic_load_explicit(&self->write_index, memory_order_acquire); \
+            if (current_index == self->cached_write_index) {                                    \
+                return NULL;                                                                    \
+            }                                                                                   \
+        }                                                                                       \
+        return &self->slots[current_index & ((N) - 1)];                                         \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_dequeue(struct name *const self, T *const element)                \
+    {                                                                                           \
+        const T *const head = name##_peek(self);                                                \
+        if (head == NULL) {                                                                     \
+            return false;                                                                       \
+        }                                                                                       \
+        if (element != NULL) {                                                                  \
+            *element = *head;                                                                   \
+        }                                                                                       \
+        const size_t current_index = atomic_load_explicit(&self->read_index, memory_order_relaxed); \
+        atomic_store_explicit(&self->read_index, current_index + 1, memory_order_release);      \
+        return true;                                                                            \
+    }                                                                                           \
+                                                                                                \
+    static inline size_t name##_count(const struct name *const self)                            \
+    {                                                                                           \
+        const size_t read_index = atomic_load_explicit(&self->read_index, memory_order_acquire); \
+        const size_t write_index = atomic_load_explicit(&self->write_index, memory_order_acquire); \
+        const size_t count = write_index - read_index;                                          \
+        return count < (N) ? count : (N);                                                       \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_is_empty(const struct name *const self)                           \
+    {                                                                                           \
+        return name##_count(self) == 0;                                                         \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_is_full(const struct name *const self)                            \
+    {                                                                                           \
+        return name##_count(self) == name##_capacity();                                         \
+    }
+
+#define DEFINE_LOCKFREE_FIFO(name, T, N)       \
+    DEFINE_LOCKFREE_FIFO_STRUCT(name, T, N);   \
+    DEFINE_LOCKFREE_FIFO_FUNCTIONS(name, T, N)
+
+#endif // LOCKFREE_FIFO_DEFINE_H
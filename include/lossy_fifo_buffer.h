@@ -0,0 +1,26 @@
+#ifndef LOSSY_FIFO_BUFFER_H
+#define LOSSY_FIFO_BUFFER_H
+
+#include <stdint.h>
+
+#include "fifo_buffer.h"
+
+// Single-producer/single-consumer ring for telemetry-like streams where fresh samples
+// matter more than old ones: enqueue never fails, and once the ring is full it
+// overwrites the oldest element. Every slot carries a seqlock-style sequence, so the
+// consumer notices elements overwritten before or while it copied them and skips
+// ahead to the oldest one still intact.
+//
+// A slot can be rewritten during a dequeue, so copy must cope with torn input (memcpy
+// does; the torn copy is discarded and retried), and peek()/peek_size() are only hints.
+struct lossy_fifo_buffer;
+
+struct lossy_fifo_buffer *lossy_fifo_buffer_new(size_t element_size, size_t count);
+void lossy_fifo_buffer_dispose(struct fifo_buffer *self);
+void lossy_fifo_buffer_delete(struct fifo_buffer *self);
+
+// Elements the consumer has skipped because the producer overwrote them; also reported
+// as fifo_buffer_stats.overwritten.
+uint64_t lossy_fifo_buffer_overwritten(const struct fifo_buffer *self);
+
+#endif // LOSSY_FIFO_BUFFER_H
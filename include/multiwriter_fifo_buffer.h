@@ -21,8 +21,19 @@ struct multiwriter_fifo_buffer {
     const union multiwriter_fifo_buffer_interface *vptr;
 };
 
+enum multiwriter_fifo_buffer_strategy {
+    // producers are serialized by a pthread mutex
+    MULTIWRITER_FIFO_BUFFER_MUTEX,
+    // producers claim slots by CAS against per-slot sequence numbers, no kernel involvement
+    MULTIWRITER_FIFO_BUFFER_LOCKFREE,
+    // producers publish their requests and whichever holds the combiner role applies the
+    // whole batch with a single write_index publication
+    MULTIWRITER_FIFO_BUFFER_COMBINING,
+};
+
 bool multiwriter_fifo_buffer_initialize(struct multiwriter_fifo_buffer *self, size_t element_size, size_t count);
 struct multiwriter_fifo_buffer *multiwriter_fifo_buffer_new(size_t element_size, size_t count);
+struct multiwriter_fifo_buffer *multiwriter_fifo_buffer_new_with_strategy(size_t element_size, size_t count, enum multiwriter_fifo_buffer_strategy strategy);
 void multiwriter_fifo_buffer_dispose(struct fifo_buffer *self);
 void multiwriter_fifo_buffer_delete(struct fifo_buffer *self);
 bool multiwriter_fifo_buffer_try_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
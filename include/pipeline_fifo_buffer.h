@@ -0,0 +1,47 @@
+#ifndef PIPELINE_FIFO_BUFFER_H
+#define PIPELINE_FIFO_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "fifo_buffer_stats.h"
+
+// Single ring shared by a producer and a chain of stages (e.g. decode -> calibrate ->
+// compress -> write). Every stage owns a cursor trailing the one before it: stage 0
+// takes what the producer committed, stage s what stage s - 1 released, and slots
+// released by the last stage go back to the producer. Elements are worked on in
+// place, so nothing is copied between stages.
+//
+// The producer and each stage are driven by one thread each, which may differ from
+// stage to stage.
+struct pipeline_fifo_buffer;
+
+struct pipeline_fifo_buffer *pipeline_fifo_buffer_new(size_t element_size, size_t count, size_t stages);
+void pipeline_fifo_buffer_delete(struct pipeline_fifo_buffer *self);
+size_t pipeline_fifo_buffer_capacity(const struct pipeline_fifo_buffer *self);
+size_t pipeline_fifo_buffer_stages(const struct pipeline_fifo_buffer *self);
+
+// Producer side. reserve_n fills up to count free slots and returns how many;
+// commit_n hands that many of them to stage 0 with the bytes written to each.
+bool pipeline_fifo_buffer_enqueue_default(struct pipeline_fifo_buffer *self, const void *element, size_t size);
+bool pipeline_fifo_buffer_enqueue(struct pipeline_fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+void *pipeline_fifo_buffer_reserve(struct pipeline_fifo_buffer *self);
+void pipeline_fifo_buffer_commit(struct pipeline_fifo_buffer *self, size_t size);
+size_t pipeline_fifo_buffer_reserve_n(struct pipeline_fifo_buffer *self, void **elements, size_t count);
+void pipeline_fifo_buffer_commit_n(struct pipeline_fifo_buffer *self, const size_t *sizes, size_t count);
+
+// Stage side: acquire_n fills up to count slots ready for stage and returns how many;
+// the stage may rewrite them in place. release passes the first count acquired slots
+// on, with their new sizes, or unchanged when sizes is NULL.
+size_t pipeline_fifo_buffer_acquire_n(struct pipeline_fifo_buffer *self, size_t stage, void **elements, size_t *sizes, size_t count);
+void pipeline_fifo_buffer_release(struct pipeline_fifo_buffer *self, size_t stage, const size_t *sizes, size_t count);
+// Elements waiting for stage.
+size_t pipeline_fifo_buffer_count(const struct pipeline_fifo_buffer *self, size_t stage);
+
+// Producer counters together with those of stage: dequeued counts the elements it
+// released, empty_polls the acquires that found nothing ready (stage starved by the one
+// before) and high_water_mark the longest backlog it saw. The stage after the longest
+// backlog is the bottleneck. false without FIFO_BUFFER_STATS.
+bool pipeline_fifo_buffer_stats_snapshot(const struct pipeline_fifo_buffer *self, size_t stage, struct fifo_buffer_stats *stats);
+
+#endif // PIPELINE_FIFO_BUFFER_H
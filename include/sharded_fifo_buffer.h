@@ -0,0 +1,31 @@
+#ifndef SHARDED_FIFO_BUFFER_H
+#define SHARDED_FIFO_BUFFER_H
+
+#include "fifo_buffer.h"
+
+// Multi-producer/single-consumer fifo_buffer made of per-producer lockfree_fifo_buffer
+// shards. A producer registers once and enqueues through the handle it gets back,
+// which is its own shard, so producers never contend with each other and each shard
+// keeps the single-producer fast path. The consumer dequeues from the buffer itself,
+// visiting the shards round-robin and taking up to weight elements from each per
+// round. Order is kept per producer, not across producers.
+//
+// Enqueueing on the buffer itself is allowed for occasional producers without a
+// handle; those go to a shared shard behind a mutex.
+struct sharded_fifo_buffer;
+
+// count is the capacity of each shard; at most max_producers handles exist at once.
+struct sharded_fifo_buffer *sharded_fifo_buffer_new(size_t element_size, size_t count, size_t max_producers);
+void sharded_fifo_buffer_dispose(struct fifo_buffer *self);
+void sharded_fifo_buffer_delete(struct fifo_buffer *self);
+
+// Producer handle (a single-producer fifo_buffer, not to be freed), or NULL when
+// max_producers are registered. A weighted shard gets up to weight elements drained per
+// round instead of one.
+struct fifo_buffer *sharded_fifo_buffer_register(struct fifo_buffer *self);
+struct fifo_buffer *sharded_fifo_buffer_register_weighted(struct fifo_buffer *self, unsigned weight);
+// The handle must not be used afterwards. Its queued elements are still delivered, and
+// the shard is reused once the consumer has drained it.
+void sharded_fifo_buffer_unregister(struct fifo_buffer *self, struct fifo_buffer *producer);
+
+#endif // SHARDED_FIFO_BUFFER_H
@@ -0,0 +1,47 @@
+#ifndef SHM_FIFO_BUFFER_H
+#define SHM_FIFO_BUFFER_H
+
+#include "fifo_buffer.h"
+#include "multiwriter_fifo_buffer.h"
+
+// Ring living in a POSIX shared memory object or memfd so that producers and consumer
+// can be separate processes. The shared region holds no pointers (slots are addressed
+// by offset from the mapping), so every process may map it at a different address.
+// Each process works through its own handle, which is a fifo_buffer, and a
+// multiwriter_fifo_buffer as well in SHM_FIFO_BUFFER_MULTIWRITER mode.
+// Operations never block; wait/until are not available across processes.
+struct shm_fifo_buffer;
+
+enum shm_fifo_buffer_mode {
+    // one producer process/thread and one consumer, like lockfree_fifo_buffer
+    SHM_FIFO_BUFFER_SINGLE_WRITER,
+    // producers are serialized by a process-shared robust mutex; a producer dying
+    // while holding it does not wedge the others
+    SHM_FIFO_BUFFER_MULTIWRITER,
+};
+
+// Creates a new shm_open object called name (must not exist yet) and formats it.
+struct shm_fifo_buffer *shm_fifo_buffer_create(const char *name, size_t element_size, size_t count, enum shm_fifo_buffer_mode mode);
+// Creates an anonymous region (memfd_create where available); share it by fork() or by
+// passing shm_fifo_buffer_fd() over a Unix socket. The descriptor is close-on-exec.
+struct shm_fifo_buffer *shm_fifo_buffer_create_anonymous(size_t element_size, size_t count, enum shm_fifo_buffer_mode mode);
+// Maps a ring formatted by another process; NULL if it is not one.
+struct shm_fifo_buffer *shm_fifo_buffer_attach(const char *name);
+// Same for a descriptor, which is duplicated so the caller keeps ownership of fd.
+struct shm_fifo_buffer *shm_fifo_buffer_attach_fd(int fd);
+// Removes the name; mappings stay valid until every handle is deleted.
+bool shm_fifo_buffer_unlink(const char *name);
+
+int shm_fifo_buffer_fd(const struct fifo_buffer *self);
+enum shm_fifo_buffer_mode shm_fifo_buffer_get_mode(const struct fifo_buffer *self);
+// Unmap and close this process's handle; the ring itself is left intact.
+void shm_fifo_buffer_dispose(struct fifo_buffer *self);
+void shm_fifo_buffer_delete(struct fifo_buffer *self);
+
+// Zero-copy access as in lockfree_fifo_buffer; reserve/commit are single-writer mode only.
+void *shm_fifo_buffer_reserve(struct fifo_buffer *self);
+void shm_fifo_buffer_commit(struct fifo_buffer *self, size_t size);
+const void *shm_fifo_buffer_acquire(struct fifo_buffer *self, size_t *size);
+void shm_fifo_buffer_release(struct fifo_buffer *self);
+
+#endif // SHM_FIFO_BUFFER_H
@@ -0,0 +1,16 @@
+#ifndef STREAM_FIFO_BUFFER_H
+#define STREAM_FIFO_BUFFER_H
+
+#include "fifo_buffer.h"
+
+// Single-producer/single-consumer ring of variable-length records packed back to back
+// in one byte arena. capacity() reports the arena size in bytes, count() the number of
+// queued records. Records larger than half the arena, length prefix included, are
+// rejected; anything up to that size is guaranteed to fit once the ring drains.
+struct stream_fifo_buffer;
+
+struct stream_fifo_buffer *stream_fifo_buffer_new(size_t arena_size);
+void stream_fifo_buffer_dispose(struct fifo_buffer *self);
+void stream_fifo_buffer_delete(struct fifo_buffer *self);
+
+#endif // STREAM_FIFO_BUFFER_H
@@ -0,0 +1,322 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "broadcast_fifo_buffer.h"
+#include "broadcast_fifo_buffer_internal.h"
+
+static inline size_t calc_capacity(const size_t count)
+{
+    size_t capacity = 1;
+    while (capacity < count) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static inline size_t round_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+struct broadcast_fifo_buffer *broadcast_fifo_buffer_new(const size_t element_size, const size_t count, const size_t max_consumers)
+{
+    if (count > (SIZE_MAX >> 1) || max_consumers > SIZE_MAX / sizeof(struct broadcast_fifo_buffer_consumer)) {
+        return NULL;
+    }
+
+    const size_t capacity = calc_capacity(count);
+    const size_t element_stride = round_up(sizeof(struct lockfree_fifo_buffer_element) + element_size, alignof(struct lockfree_fifo_buffer_element));
+    if (capacity > (SIZE_MAX - LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) / element_stride) {
+        return NULL;
+    }
+
+    struct broadcast_fifo_buffer *const self = aligned_alloc(alignof(struct broadcast_fifo_buffer), sizeof(struct broadcast_fifo_buffer));
+    uint8_t *const buffer = (uint8_t *)aligned_alloc(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE, round_up(capacity * element_stride, LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE));
+    // sizeof is a multiple of the cache line because read_index is aligned to it
+    struct broadcast_fifo_buffer_consumer *const consumers = aligned_alloc(alignof(struct broadcast_fifo_buffer_consumer), (max_consumers > 0 ? max_consumers : 1) * sizeof(struct broadcast_fifo_buffer_consumer));
+    if (self == NULL || buffer == NULL || consumers == NULL) {
+        free(self);
+        free(buffer);
+        free(consumers);
+        return NULL;
+    }
+
+    *self = (struct broadcast_fifo_buffer){
+        .element_size = element_size,
+        .capacity = capacity,
+        .element_stride = element_stride,
+        .buffer = buffer,
+        .max_consumers = max_consumers,
+        .consumers = consumers,
+        .gate_index = 0,
+    };
+    atomic_init(&self->write_index, 0);
+
+    if (pthread_mutex_init(&self->lock, NULL) != 0) {
+        free(consumers);
+        free(buffer);
+        free(self);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < max_consumers; i++) {
+        consumers[i] = (struct broadcast_fifo_buffer_consumer){
+            .cached_write_index = 0,
+            .ring = self,
+            .registered = false,
+        };
+        atomic_init(&consumers[i].read_index, 0);
+    }
+
+    return self;
+}
+
+void broadcast_fifo_buffer_delete(struct broadcast_fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    pthread_mutex_destroy(&self->lock);
+    free(self->consumers);
+    free(self->buffer);
+    free(self);
+}
+
+size_t broadcast_fifo_buffer_capacity(const struct broadcast_fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return self->capacity;
+}
+
+// Recomputes gate_index from the registered consumers; current_index when there are none.
+static void update_gate(struct broadcast_fifo_buffer *const self, const size_t current_index)
+{
+    pthread_mutex_lock(&self->lock);
+
+    size_t behind = 0;
+    for (size_t i = 0; i < self->max_consumers; i++) {
+        const struct broadcast_fifo_buffer_consumer *const consumer = &self->consumers[i];
+        if (!consumer->registered) {
+            continue;
+        }
+
+        const size_t distance = current_index - atomic_load_explicit(&consumer->read_index, memory_order_acquire);
+        if (distance > behind) {
+            behind = distance;
+        }
+    }
+    self->gate_index = current_index - behind;
+
+    pthread_mutex_unlock(&self->lock);
+}
+
+static bool has_room(struct broadcast_fifo_buffer *const self, const size_t current_index)
+{
+    if (current_index - self->gate_index < self->capacity) {
+        return true;
+    }
+
+    update_gate(self, current_index);
+    return current_index - self->gate_index < self->capacity;
+}
+
+bool broadcast_fifo_buffer_enqueue_default(struct broadcast_fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return broadcast_fifo_buffer_enqueue(self, element, size, memcpy);
+}
+
+bool broadcast_fifo_buffer_enqueue(struct broadcast_fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    assert(size <= self->element_size);
+
+    void *const dest = broadcast_fifo_buffer_reserve(self);
+    if (dest == NULL) {
+        return false;
+    }
+
+    copy(dest, element, size);
+    broadcast_fifo_buffer_commit(self, size);
+    return true;
+}
+
+void *broadcast_fifo_buffer_reserve(struct broadcast_fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const size_t current_index = atomic_load_explicit(&self->write_index, memory_order_relaxed);
+    if (!has_room(self, current_index)) {
+        FIFO_BUFFER_STATS_ADD(self->producer_stats.full_rejects, 1);
+        return NULL;
+    }
+
+    return broadcast_fifo_buffer_element_at(self, current_index)->buffer;
+}
+
+void broadcast_fifo_buffer_commit(struct broadcast_fifo_buffer *const self, const size_t size)
+{
+    assert(self != NULL);
+    assert(size <= self->element_size);
+
+    const size_t current_index = atomic_load_explicit(&self->write_index, memory_order_relaxed);
+    assert(current_index - self->gate_index < self->capacity);
+
+    broadcast_fifo_buffer_element_at(self, current_index)->size = size;
+    atomic_store_explicit(&self->write_index, current_index + 1, memory_order_release);
+    FIFO_BUFFER_STATS_RECORD_ENQUEUE(self->producer_stats, size, 1);
+}
+
+bool broadcast_fifo_buffer_is_full(struct broadcast_fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return !has_room(self, atomic_load_explicit(&self->write_index, memory_order_relaxed));
+}
+
+struct broadcast_fifo_buffer_consumer *broadcast_fifo_buffer_register(struct broadcast_fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    struct broadcast_fifo_buffer_consumer *found = NULL;
+    pthread_mutex_lock(&self->lock);
+
+    for (size_t i = 0; i < self->max_consumers && found == NULL; i++) {
+        if (!self->consumers[i].registered) {
+            found = &self->consumers[i];
+        }
+    }
+
+    if (found != NULL) {
+        // The producer only writes positions below gate_index + capacity until it
+        // takes the lock again, so nothing from write_index on can be overwritten.
+        const size_t write_index = atomic_load_explicit(&self->write_index, memory_order_acquire);
+        atomic_store_explicit(&found->read_index, write_index, memory_order_relaxed);
+        found->cached_write_index = write_index;
+        found->registered = true;
+#if defined(FIFO_BUFFER_STATS)
+        atomic_store_explicit(&found->consumer_stats.dequeued, 0, memory_order_relaxed);
+        atomic_store_explicit(&found->consumer_stats.empty_polls, 0, memory_order_relaxed);
+        atomic_store_explicit(&found->consumer_stats.high_water_mark, 0, memory_order_relaxed);
+#endif
+    }
+
+    pthread_mutex_unlock(&self->lock);
+    return found;
+}
+
+void broadcast_fifo_buffer_unregister(struct broadcast_fifo_buffer_consumer *const consumer)
+{
+    assert(consumer != NULL);
+
+    struct broadcast_fifo_buffer *const ring = consumer->ring;
+    pthread_mutex_lock(&ring->lock);
+    assert(consumer->registered);
+    consumer->registered = false;
+    pthread_mutex_unlock(&ring->lock);
+}
+
+const void *broadcast_fifo_buffer_acquire(struct broadcast_fifo_buffer_consumer *const consumer, size_t *const size)
+{
+    const void *element = NULL;
+    if (broadcast_fifo_buffer_acquire_n(consumer, &element, size, 1) == 0) {
+        return NULL;
+    }
+
+    return element;
+}
+
+size_t broadcast_fifo_buffer_acquire_n(struct broadcast_fifo_buffer_consumer *const consumer, const void **const elements, size_t *const sizes, const size_t count)
+{
+    assert(consumer != NULL);
+    assert(elements != NULL);
+
+    const struct broadcast_fifo_buffer *const ring = consumer->ring;
+    const size_t current_index = atomic_load_explicit(&consumer->read_index, memory_order_relaxed);
+
+    size_t available = consumer->cached_write_index - current_index;
+    if (available < count) {
+        consumer->cached_write_index = atomic_load_explicit(&ring->write_index, memory_order_acquire);
+        available = consumer->cached_write_index - current_index;
+        FIFO_BUFFER_STATS_RECORD_OCCUPANCY(consumer->consumer_stats.high_water_mark, available);
+    }
+
+    const size_t acquired = available < count ? available : count;
+    if (acquired == 0 && count > 0) {
+        FIFO_BUFFER_STATS_ADD(consumer->consumer_stats.empty_polls, 1);
+    }
+    for (size_t i = 0; i < acquired; i++) {
+        const struct lockfree_fifo_buffer_element *const element = broadcast_fifo_buffer_element_at(ring, current_index + i);
+        elements[i] = element->buffer;
+        if (sizes != NULL) {
+            sizes[i] = element->size;
+        }
+    }
+
+    return acquired;
+}
+
+void broadcast_fifo_buffer_release(struct broadcast_fifo_buffer_consumer *const consumer, const size_t count)
+{
+    assert(consumer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&consumer->read_index, memory_order_relaxed);
+    assert(consumer->cached_write_index - current_index >= count);
+
+    atomic_store_explicit(&consumer->read_index, current_index + count, memory_order_release);
+    FIFO_BUFFER_STATS_ADD(consumer->consumer_stats.dequeued, count);
+}
+
+bool broadcast_fifo_buffer_dequeue_default(struct broadcast_fifo_buffer_consumer *const consumer, void *const element)
+{
+    return broadcast_fifo_buffer_dequeue(consumer, element, memcpy);
+}
+
+bool broadcast_fifo_buffer_dequeue(struct broadcast_fifo_buffer_consumer *const consumer, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    size_t size = 0;
+    const void *const src = broadcast_fifo_buffer_acquire(consumer, &size);
+    if (src == NULL) {
+        return false;
+    }
+
+    if (element != NULL) {
+        copy(element, src, size);
+    }
+    broadcast_fifo_buffer_release(consumer, 1);
+    return true;
+}
+
+size_t broadcast_fifo_buffer_count(const struct broadcast_fifo_buffer_consumer *const consumer)
+{
+    assert(consumer != NULL);
+
+    const size_t read_index = atomic_load_explicit(&consumer->read_index, memory_order_acquire);
+    const size_t write_index = atomic_load_explicit(&consumer->ring->write_index, memory_order_acquire);
+    return write_index - read_index;
+}
+
+bool broadcast_fifo_buffer_is_empty(const struct broadcast_fifo_buffer_consumer *const consumer)
+{
+    return broadcast_fifo_buffer_count(consumer) == 0;
+}
+
+bool broadcast_fifo_buffer_stats_snapshot(const struct broadcast_fifo_buffer_consumer *const consumer, struct fifo_buffer_stats *const stats)
+{
+    assert(consumer != NULL);
+    assert(stats != NULL);
+
+#if defined(FIFO_BUFFER_STATS)
+    fifo_buffer_stats_collect(&consumer->ring->producer_stats, &consumer->consumer_stats, stats);
+    return true;
+#else
+    (void)consumer;
+    (void)stats;
+    return false;
+#endif
+}
@@ -0,0 +1,53 @@
+#ifndef BROADCAST_FIFO_BUFFER_INTERNAL_H
+#define BROADCAST_FIFO_BUFFER_INTERNAL_H
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "broadcast_fifo_buffer.h"
+#include "fifo_buffer_stats_internal.h"
+#include "lockfree_fifo_buffer_internal.h"
+
+struct broadcast_fifo_buffer_consumer {
+    // free-running like lockfree_fifo_buffer's read_index; written by the owning
+    // consumer, read by the producer when it looks for the slowest consumer
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t read_index;
+    size_t cached_write_index;
+    struct broadcast_fifo_buffer *ring;
+    // guarded by ring->lock
+    bool registered;
+#if defined(FIFO_BUFFER_STATS)
+    struct fifo_buffer_consumer_stats consumer_stats;
+#endif
+};
+
+struct broadcast_fifo_buffer {
+    size_t element_size;
+    size_t capacity;
+    size_t element_stride;
+    uint8_t *buffer;
+    size_t max_consumers;
+    struct broadcast_fifo_buffer_consumer *consumers;
+    // serializes registration against the producer recomputing gate_index
+    pthread_mutex_t lock;
+
+    // producer side
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t write_index;
+    // read_index of the slowest consumer when last looked at, under lock; a consumer
+    // registering later starts at write_index, which is never behind it
+    size_t gate_index;
+#if defined(FIFO_BUFFER_STATS)
+    struct fifo_buffer_producer_stats producer_stats;
+#endif
+};
+
+static inline struct lockfree_fifo_buffer_element *broadcast_fifo_buffer_element_at(const struct broadcast_fifo_buffer *const self, const size_t index)
+{
+    return (struct lockfree_fifo_buffer_element *)(self->buffer + (index & (self->capacity - 1)) * self->element_stride);
+}
+
+#endif // BROADCAST_FIFO_BUFFER_INTERNAL_H
@@ -0,0 +1,291 @@
+#include <assert.h>
+#include <sched.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "combining_fifo_buffer_internal.h"
+
+static const union multiwriter_fifo_buffer_interface vtable = {
+    .dispose = combining_fifo_buffer_dispose,
+    .free = combining_fifo_buffer_delete,
+    .capacity = lockfree_fifo_buffer_capacity,
+    .count = lockfree_fifo_buffer_count,
+    .enqueue_default = combining_fifo_buffer_enqueue_default,
+    .enqueue = combining_fifo_buffer_enqueue,
+    .dequeue_default = lockfree_fifo_buffer_dequeue_default,
+    .dequeue = lockfree_fifo_buffer_dequeue,
+    .enqueue_bulk = combining_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = lockfree_fifo_buffer_dequeue_bulk,
+    .peek = lockfree_fifo_buffer_peek,
+    .peek_size = lockfree_fifo_buffer_peek_size,
+    .is_empty = lockfree_fifo_buffer_is_empty,
+    .is_full = lockfree_fifo_buffer_is_full,
+    .stats_snapshot = combining_fifo_buffer_stats_snapshot,
+    .try_enqueue_default = combining_fifo_buffer_try_enqueue_default,
+    .try_enqueue = combining_fifo_buffer_try_enqueue,
+};
+
+// spreads threads over the records so they rarely probe the same one first
+static atomic_size_t next_record_hint;
+static _Thread_local size_t record_hint;
+
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static inline void backoff(const struct combining_fifo_buffer *const self, unsigned *const spins)
+{
+    if (*spins < self->super.spin_budget) {
+        (*spins)++;
+        cpu_relax();
+    } else {
+        sched_yield();
+    }
+}
+
+bool combining_fifo_buffer_initialize(struct combining_fifo_buffer *const self, const size_t element_size, const size_t count)
+{
+    assert(self != NULL);
+
+    if (!lockfree_fifo_buffer_initialize(&self->super, element_size, count)) {
+        return false;
+    }
+
+    self->parent.vptr = &vtable.parent;
+    atomic_init(&self->combining, false);
+#if defined(FIFO_BUFFER_STATS)
+    atomic_init(&self->trylock_failures, 0);
+#endif
+    for (size_t i = 0; i < COMBINING_FIFO_BUFFER_RECORDS; i++) {
+        atomic_init(&self->records[i].state, COMBINING_FIFO_BUFFER_RECORD_FREE);
+    }
+
+    return true;
+}
+
+struct multiwriter_fifo_buffer *combining_fifo_buffer_new(const size_t element_size, const size_t count)
+{
+    struct combining_fifo_buffer *const buf = (struct combining_fifo_buffer *)aligned_alloc(alignof(struct combining_fifo_buffer), sizeof(struct combining_fifo_buffer));
+    if (buf == NULL) {
+        return NULL;
+    }
+
+    if (!combining_fifo_buffer_initialize(buf, element_size, count)) {
+        free(buf);
+        return NULL;
+    }
+
+    return &buf->multiwriter;
+}
+
+void combining_fifo_buffer_dispose(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    lockfree_fifo_buffer_dispose(self);
+}
+
+void combining_fifo_buffer_delete(struct fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    combining_fifo_buffer_dispose(self);
+    free(self);
+}
+
+// Writes a request behind what this batch has written so far, without publishing it.
+// Only the combiner calls this, so the producer-side fields of the ring are its own.
+static size_t apply(struct combining_fifo_buffer *const self, size_t *const next_index, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    struct lockfree_fifo_buffer *const ring = &self->super;
+
+    size_t available = ring->capacity - (*next_index - ring->cached_read_index);
+    if (available < count) {
+        ring->cached_read_index = atomic_load_explicit(&ring->read_index, memory_order_acquire);
+        available = ring->capacity - (*next_index - ring->cached_read_index);
+    }
+
+    const size_t transferred = available < count ? available : count;
+    const uint8_t *const src = (const uint8_t *)elements;
+    for (size_t i = 0; i < transferred; i++) {
+        struct lockfree_fifo_buffer_element *const dest = lockfree_fifo_buffer_element_at(ring, *next_index + i);
+        copy(dest->buffer, src + i * size, size);
+        dest->size = size;
+    }
+    *next_index += transferred;
+
+    if (transferred < count) {
+        FIFO_BUFFER_STATS_ADD(ring->producer_stats.full_rejects, 1);
+    }
+    if (transferred > 0) {
+        FIFO_BUFFER_STATS_RECORD_ENQUEUE(ring->producer_stats, size, transferred);
+    }
+    return transferred;
+}
+
+// Runs with the combiner role held: applies the caller's own request, if any, and
+// every pending record in one batch, then publishes write_index once.
+static size_t combine(struct combining_fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    struct lockfree_fifo_buffer *const ring = &self->super;
+
+    const size_t start_index = atomic_load_explicit(&ring->write_index, memory_order_relaxed);
+    size_t next_index = start_index;
+
+    const size_t result = count > 0 ? apply(self, &next_index, elements, size, count, copy) : 0;
+
+    size_t applied[COMBINING_FIFO_BUFFER_RECORDS];
+    size_t applied_count = 0;
+    for (size_t i = 0; i < COMBINING_FIFO_BUFFER_RECORDS; i++) {
+        struct combining_fifo_buffer_record *const record = &self->records[i];
+        if (atomic_load_explicit(&record->state, memory_order_acquire) != COMBINING_FIFO_BUFFER_RECORD_PENDING) {
+            continue;
+        }
+        record->result = apply(self, &next_index, record->elements, record->size, record->count, record->copy);
+        applied[applied_count++] = i;
+    }
+
+    if (next_index != start_index) {
+        atomic_store_explicit(&ring->write_index, next_index, memory_order_release);
+        fifo_buffer_wait_point_notify(&ring->not_empty);
+    }
+    // only after the publication, so a producer never sees its request done before the consumer can
+    for (size_t i = 0; i < applied_count; i++) {
+        atomic_store_explicit(&self->records[applied[i]].state, COMBINING_FIFO_BUFFER_RECORD_DONE, memory_order_release);
+    }
+
+    return result;
+}
+
+static inline bool try_acquire_combiner(struct combining_fifo_buffer *const self)
+{
+    return !atomic_load_explicit(&self->combining, memory_order_relaxed)
+        && !atomic_exchange_explicit(&self->combining, true, memory_order_acquire);
+}
+
+static inline void release_combiner(struct combining_fifo_buffer *const self)
+{
+    atomic_store_explicit(&self->combining, false, memory_order_release);
+}
+
+static struct combining_fifo_buffer_record *claim_record(struct combining_fifo_buffer *const self)
+{
+    if (record_hint == 0) {
+        record_hint = atomic_fetch_add_explicit(&next_record_hint, 1, memory_order_relaxed) + 1;
+    }
+
+    for (size_t i = 0; i < COMBINING_FIFO_BUFFER_RECORDS; i++) {
+        struct combining_fifo_buffer_record *const record = &self->records[(record_hint + i) % COMBINING_FIFO_BUFFER_RECORDS];
+        unsigned expected = COMBINING_FIFO_BUFFER_RECORD_FREE;
+        if (atomic_load_explicit(&record->state, memory_order_relaxed) == expected
+            && atomic_compare_exchange_strong_explicit(&record->state, &expected, COMBINING_FIFO_BUFFER_RECORD_CLAIMED, memory_order_acquire, memory_order_relaxed)) {
+            return record;
+        }
+    }
+
+    return NULL;
+}
+
+static size_t submit(struct combining_fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    unsigned spins = 0;
+    struct combining_fifo_buffer_record *record;
+    while ((record = claim_record(self)) == NULL) {
+        // every record is taken: serve ourselves once the role is free
+        if (try_acquire_combiner(self)) {
+            const size_t result = combine(self, elements, size, count, copy);
+            release_combiner(self);
+            return result;
+        }
+        backoff(self, &spins);
+    }
+
+    record->elements = elements;
+    record->size = size;
+    record->count = count;
+    record->copy = copy;
+    atomic_store_explicit(&record->state, COMBINING_FIFO_BUFFER_RECORD_PENDING, memory_order_release);
+
+    spins = 0;
+    while (atomic_load_explicit(&record->state, memory_order_acquire) != COMBINING_FIFO_BUFFER_RECORD_DONE) {
+        if (try_acquire_combiner(self)) {
+            // our own record is pending, so this batch includes it
+            combine(self, NULL, 0, 0, NULL);
+            release_combiner(self);
+            continue;
+        }
+        backoff(self, &spins);
+    }
+
+    const size_t result = record->result;
+    atomic_store_explicit(&record->state, COMBINING_FIFO_BUFFER_RECORD_FREE, memory_order_release);
+    return result;
+}
+
+bool combining_fifo_buffer_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return combining_fifo_buffer_enqueue(self, element, size, memcpy);
+}
+
+bool combining_fifo_buffer_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    assert(size <= ((struct lockfree_fifo_buffer *)self)->element_size);
+
+    return submit((struct combining_fifo_buffer *)self, element, size, 1, copy) == 1;
+}
+
+size_t combining_fifo_buffer_enqueue_bulk(struct fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    assert(size <= ((struct lockfree_fifo_buffer *)self)->element_size);
+
+    if (count == 0) {
+        return 0;
+    }
+    return submit((struct combining_fifo_buffer *)self, elements, size, count, copy);
+}
+
+bool combining_fifo_buffer_try_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return combining_fifo_buffer_try_enqueue(self, element, size, memcpy);
+}
+
+bool combining_fifo_buffer_try_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    assert(size <= ((struct lockfree_fifo_buffer *)self)->element_size);
+
+    struct combining_fifo_buffer *const _self = (struct combining_fifo_buffer *)self;
+    if (!try_acquire_combiner(_self)) {
+        FIFO_BUFFER_STATS_ADD_SHARED(_self->trylock_failures, 1);
+        return false;
+    }
+    const bool result = combine(_self, element, size, 1, copy) == 1;
+    release_combiner(_self);
+
+    return result;
+}
+
+bool combining_fifo_buffer_stats_snapshot(const struct fifo_buffer *const self, struct fifo_buffer_stats *const stats)
+{
+    if (!lockfree_fifo_buffer_stats_snapshot(self, stats)) {
+        return false;
+    }
+
+#if defined(FIFO_BUFFER_STATS)
+    stats->trylock_failures = atomic_load_explicit(&((const struct combining_fifo_buffer *)self)->trylock_failures, memory_order_relaxed);
+#endif
+    return true;
+}
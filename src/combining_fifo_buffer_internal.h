@@ -0,0 +1,62 @@
+#ifndef COMBINING_FIFO_BUFFER_INTERNAL_H
+#define COMBINING_FIFO_BUFFER_INTERNAL_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "fifo_buffer.h"
+#include "fifo_buffer_stats_internal.h"
+#include "lockfree_fifo_buffer_internal.h"
+#include "multiwriter_fifo_buffer.h"
+
+// producers past this many share records by waiting for one or combining themselves
+#define COMBINING_FIFO_BUFFER_RECORDS 32
+
+enum combining_fifo_buffer_record_state {
+    COMBINING_FIFO_BUFFER_RECORD_FREE,
+    // taken by a producer that is still filling in its request
+    COMBINING_FIFO_BUFFER_RECORD_CLAIMED,
+    COMBINING_FIFO_BUFFER_RECORD_PENDING,
+    // applied by a combiner, result is valid
+    COMBINING_FIFO_BUFFER_RECORD_DONE,
+};
+
+// Enqueue request a producer publishes for whichever thread holds the combiner role.
+struct combining_fifo_buffer_record {
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_uint state;
+    const void *elements;
+    size_t size;
+    size_t count;
+    void *(*copy)(void *, const void *, size_t);
+    // number of elements that fit
+    size_t result;
+};
+
+// The consumer side is the plain lockfree ring; producers never touch write_index
+// themselves, the combiner writes every pending request and publishes it once.
+struct combining_fifo_buffer {
+    union {
+        struct fifo_buffer parent;
+        struct multiwriter_fifo_buffer multiwriter;
+        struct lockfree_fifo_buffer super;
+    };
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_bool combining;
+#if defined(FIFO_BUFFER_STATS)
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_uint_fast64_t trylock_failures;
+#endif
+    struct combining_fifo_buffer_record records[COMBINING_FIFO_BUFFER_RECORDS];
+};
+
+bool combining_fifo_buffer_initialize(struct combining_fifo_buffer *self, size_t element_size, size_t count);
+struct multiwriter_fifo_buffer *combining_fifo_buffer_new(size_t element_size, size_t count);
+void combining_fifo_buffer_dispose(struct fifo_buffer *self);
+void combining_fifo_buffer_delete(struct fifo_buffer *self);
+bool combining_fifo_buffer_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool combining_fifo_buffer_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+size_t combining_fifo_buffer_enqueue_bulk(struct fifo_buffer *self, const void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+bool combining_fifo_buffer_try_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool combining_fifo_buffer_try_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+bool combining_fifo_buffer_stats_snapshot(const struct fifo_buffer *self, struct fifo_buffer_stats *stats);
+
+#endif // COMBINING_FIFO_BUFFER_INTERNAL_H
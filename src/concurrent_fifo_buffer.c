@@ -0,0 +1,163 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "concurrent_fifo_buffer.h"
+#include "fifo_buffer_stats_internal.h"
+#include "concurrent_fifo_buffer_internal.h"
+
+static const union concurrent_fifo_buffer_interface vtable = {
+    .dispose = sequenced_fifo_buffer_dispose,
+    .free = concurrent_fifo_buffer_delete,
+    .capacity = sequenced_fifo_buffer_capacity,
+    .count = sequenced_fifo_buffer_count,
+    .enqueue_default = sequenced_fifo_buffer_enqueue_default,
+    .enqueue = sequenced_fifo_buffer_enqueue,
+    .dequeue_default = concurrent_fifo_buffer_dequeue_default,
+    .dequeue = concurrent_fifo_buffer_dequeue,
+    .enqueue_bulk = sequenced_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = concurrent_fifo_buffer_dequeue_bulk,
+    .peek = sequenced_fifo_buffer_peek,
+    .peek_size = sequenced_fifo_buffer_peek_size,
+    .is_empty = sequenced_fifo_buffer_is_empty,
+    .is_full = sequenced_fifo_buffer_is_full,
+    .stats_snapshot = fifo_buffer_stats_unavailable,
+    .try_enqueue_default = sequenced_fifo_buffer_try_enqueue_default,
+    .try_enqueue = sequenced_fifo_buffer_try_enqueue,
+    .try_dequeue_default = concurrent_fifo_buffer_try_dequeue_default,
+    .try_dequeue = concurrent_fifo_buffer_try_dequeue,
+};
+
+struct concurrent_fifo_buffer *concurrent_fifo_buffer_new(const size_t element_size, const size_t count)
+{
+    struct sequenced_fifo_buffer *const buf = aligned_alloc(alignof(struct sequenced_fifo_buffer), sizeof(struct sequenced_fifo_buffer));
+    if (buf == NULL) {
+        return NULL;
+    }
+
+    if (!sequenced_fifo_buffer_initialize(buf, element_size, count)) {
+        free(buf);
+        return NULL;
+    }
+
+    buf->concurrent.vptr = &vtable;
+    return &buf->concurrent;
+}
+
+void concurrent_fifo_buffer_delete(struct fifo_buffer *const self)
+{
+    sequenced_fifo_buffer_delete(self);
+}
+
+// Copies at most size bytes, so an element larger than the caller's stride is truncated.
+static inline void consume(struct sequenced_fifo_buffer *const self, struct sequenced_element *const src, const size_t index, void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    if (element != NULL && copy != NULL) {
+        copy(element, src->buffer, src->size < size ? src->size : size);
+    }
+    atomic_store_explicit(&src->sequence, index + self->capacity, memory_order_release);
+}
+
+bool concurrent_fifo_buffer_dequeue_default(struct fifo_buffer *const self, void *const element)
+{
+    return concurrent_fifo_buffer_dequeue(self, element, memcpy);
+}
+
+bool concurrent_fifo_buffer_dequeue(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct sequenced_fifo_buffer *const _self = (struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+    for (;;) {
+        struct sequenced_element *const src = sequenced_fifo_buffer_element_at(_self, current_index);
+        const size_t sequence = atomic_load_explicit(&src->sequence, memory_order_acquire);
+        const intptr_t distance = (intptr_t)(sequence - (current_index + 1));
+
+        if (distance == 0) {
+            if (atomic_compare_exchange_weak_explicit(&_self->read_index, &current_index, current_index + 1, memory_order_relaxed, memory_order_relaxed)) {
+                consume(_self, src, current_index, element, _self->element_size, copy);
+                return true;
+            }
+        } else if (distance < 0) {
+            return false;
+        } else {
+            current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+        }
+    }
+}
+
+bool concurrent_fifo_buffer_try_dequeue_default(struct fifo_buffer *const self, void *const element)
+{
+    return concurrent_fifo_buffer_try_dequeue(self, element, memcpy);
+}
+
+bool concurrent_fifo_buffer_try_dequeue(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct sequenced_fifo_buffer *const _self = (struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    // a single claim attempt: fails when the ring is empty or another consumer won the slot
+    size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+    struct sequenced_element *const src = sequenced_fifo_buffer_element_at(_self, current_index);
+    if (atomic_load_explicit(&src->sequence, memory_order_acquire) != current_index + 1) {
+        return false;
+    }
+    if (!atomic_compare_exchange_strong_explicit(&_self->read_index, &current_index, current_index + 1, memory_order_relaxed, memory_order_relaxed)) {
+        return false;
+    }
+
+    consume(_self, src, current_index, element, _self->element_size, copy);
+    return true;
+}
+
+size_t concurrent_fifo_buffer_dequeue_bulk(struct fifo_buffer *const self, void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct sequenced_fifo_buffer *const _self = (struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    if (count == 0) {
+        return 0;
+    }
+
+    size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+    size_t transferred;
+    for (;;) {
+        // a slot is readable for this lap once its sequence equals its position + 1
+        size_t sequence = current_index + 1;
+        for (transferred = 0; transferred < count && transferred < _self->capacity; transferred++) {
+            const size_t index = current_index + transferred;
+            sequence = atomic_load_explicit(&sequenced_fifo_buffer_element_at(_self, index)->sequence, memory_order_acquire);
+            if (sequence != index + 1) {
+                break;
+            }
+        }
+
+        if (transferred > 0) {
+            if (atomic_compare_exchange_weak_explicit(&_self->read_index, &current_index, current_index + transferred, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if ((intptr_t)(sequence - (current_index + 1)) < 0) {
+            return 0;
+        } else {
+            current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+        }
+    }
+
+    uint8_t *const dest = (uint8_t *)elements;
+    for (size_t i = 0; i < transferred; i++) {
+        const size_t index = current_index + i;
+        consume(_self, sequenced_fifo_buffer_element_at(_self, index), index, dest != NULL ? dest + i * size : NULL, size, copy);
+    }
+    return transferred;
+}
@@ -0,0 +1,16 @@
+#ifndef CONCURRENT_FIFO_BUFFER_INTERNAL_H
+#define CONCURRENT_FIFO_BUFFER_INTERNAL_H
+
+#include "sequenced_fifo_buffer_internal.h"
+
+#include "concurrent_fifo_buffer.h"
+
+union concurrent_fifo_buffer_interface;
+
+bool concurrent_fifo_buffer_dequeue_default(struct fifo_buffer *self, void *element);
+bool concurrent_fifo_buffer_dequeue(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
+bool concurrent_fifo_buffer_try_dequeue_default(struct fifo_buffer *self, void *element);
+bool concurrent_fifo_buffer_try_dequeue(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
+size_t concurrent_fifo_buffer_dequeue_bulk(struct fifo_buffer *self, void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+
+#endif // CONCURRENT_FIFO_BUFFER_INTERNAL_H
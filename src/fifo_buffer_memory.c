@@ -0,0 +1,205 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include "fifo_buffer_memory_internal.h"
+
+// from <linux/mempolicy.h>, called through syscall(2) so libnuma is not needed
+#define MPOL_BIND 2
+
+#define BITS_PER_WORD (sizeof(unsigned long) * CHAR_BIT)
+#define DEFAULT_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+int fifo_buffer_memory_current_node(void)
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) {
+        return (int)node;
+    }
+#endif
+    return 0;
+}
+
+static size_t huge_page_size(void)
+{
+    static atomic_size_t cached;
+    const size_t known = atomic_load_explicit(&cached, memory_order_relaxed);
+    if (known != 0) {
+        return known;
+    }
+
+    size_t size = DEFAULT_HUGE_PAGE_SIZE;
+    FILE *const meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo != NULL) {
+        char line[128];
+        unsigned long kilobytes = 0;
+        while (fgets(line, sizeof(line), meminfo) != NULL) {
+            if (sscanf(line, "Hugepagesize: %lu kB", &kilobytes) == 1 && kilobytes > 0) {
+                size = (size_t)kilobytes << 10;
+                break;
+            }
+        }
+        fclose(meminfo);
+    }
+    atomic_store_explicit(&cached, size, memory_order_relaxed);
+    return size;
+}
+
+static size_t page_size_of(const enum fifo_buffer_page_backing backing)
+{
+    return backing == FIFO_BUFFER_PAGES_SMALL ? (size_t)sysconf(_SC_PAGESIZE) : huge_page_size();
+}
+
+static size_t mapped_size(const size_t size, const enum fifo_buffer_page_backing backing)
+{
+    const size_t page_size = page_size_of(backing);
+    const size_t pages = size > 0 ? (size + page_size - 1) / page_size : 1;
+    return pages * page_size;
+}
+
+// THP is off for everybody when the sysfs switch says [never], and madvise cannot change that
+static bool transparent_huge_pages_enabled(void)
+{
+    FILE *const enabled = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (enabled == NULL) {
+        return false;
+    }
+
+    char line[128] = { 0 };
+    const bool result = fgets(line, sizeof(line), enabled) != NULL && strstr(line, "[never]") == NULL;
+    fclose(enabled);
+    return result;
+}
+
+static void *map_hugetlb(const size_t size)
+{
+#if defined(MAP_HUGETLB)
+    void *const memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+#else
+    (void)size;
+    return NULL;
+#endif
+}
+
+// Maps size bytes (a multiple of the huge page size) starting on a huge page boundary,
+// so that khugepaged or the fault path can back all of it with huge pages.
+static void *map_transparent_huge(const size_t size)
+{
+#if defined(MADV_HUGEPAGE)
+    if (!transparent_huge_pages_enabled()) {
+        return NULL;
+    }
+
+    const size_t alignment = huge_page_size();
+    uint8_t *const memory = mmap(NULL, size + alignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+
+    uint8_t *const aligned = (uint8_t *)(((uintptr_t)memory + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    if (aligned > memory) {
+        munmap(memory, (size_t)(aligned - memory));
+    }
+    if (aligned + size < memory + size + alignment) {
+        munmap(aligned + size, (size_t)(memory + size + alignment - (aligned + size)));
+    }
+
+    if (madvise(aligned, size, MADV_HUGEPAGE) != 0) {
+        munmap(aligned, size);
+        return NULL;
+    }
+    return aligned;
+#else
+    (void)size;
+    return NULL;
+#endif
+}
+
+static void *map_small(const size_t size)
+{
+    void *const memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+}
+
+static bool bind_to_node(void *const memory, const size_t size, const int node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    unsigned long nodemask[FIFO_BUFFER_MEMORY_MAX_NODES / BITS_PER_WORD] = { 0 };
+    nodemask[(size_t)node / BITS_PER_WORD] = 1UL << ((size_t)node % BITS_PER_WORD);
+
+    // the kernel reads maxnode - 1 bits
+    if (syscall(SYS_mbind, memory, size, MPOL_BIND, nodemask, FIFO_BUFFER_MEMORY_MAX_NODES + 1, 0) == 0) {
+        return true;
+    }
+    // a kernel without NUMA support has a single node, so every page is local
+    return errno == ENOSYS && node == 0;
+#else
+    (void)memory;
+    (void)size;
+    return node == 0;
+#endif
+}
+
+void *fifo_buffer_memory_map(const size_t size, const int node, enum fifo_buffer_page_backing *const backing)
+{
+    if (node >= FIFO_BUFFER_MEMORY_MAX_NODES) {
+        return NULL;
+    }
+
+    void *memory = NULL;
+    switch (*backing) {
+    case FIFO_BUFFER_PAGES_HUGETLB:
+        memory = map_hugetlb(mapped_size(size, FIFO_BUFFER_PAGES_HUGETLB));
+        if (memory != NULL) {
+            break;
+        }
+        *backing = FIFO_BUFFER_PAGES_TRANSPARENT_HUGE;
+        // fall through
+    case FIFO_BUFFER_PAGES_TRANSPARENT_HUGE:
+        memory = map_transparent_huge(mapped_size(size, FIFO_BUFFER_PAGES_TRANSPARENT_HUGE));
+        if (memory != NULL) {
+            break;
+        }
+        *backing = FIFO_BUFFER_PAGES_SMALL;
+        // fall through
+    case FIFO_BUFFER_PAGES_SMALL:
+    default:
+        *backing = FIFO_BUFFER_PAGES_SMALL;
+        memory = map_small(mapped_size(size, FIFO_BUFFER_PAGES_SMALL));
+        break;
+    }
+    if (memory == NULL) {
+        return NULL;
+    }
+
+    if (node >= 0 && !bind_to_node(memory, mapped_size(size, *backing), node)) {
+        munmap(memory, mapped_size(size, *backing));
+        return NULL;
+    }
+    return memory;
+}
+
+void fifo_buffer_memory_unmap(void *const memory, const size_t size, const enum fifo_buffer_page_backing backing)
+{
+    if (memory != NULL) {
+        munmap(memory, mapped_size(size, backing));
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef FIFO_BUFFER_MEMORY_INTERNAL_H
+#define FIFO_BUFFER_MEMORY_INTERNAL_H
+
+#include <stddef.h>
+
+#include "fifo_buffer_stats.h"
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L
+#error "This library requires ISO/IEC 9899:2011 conformance environment to build."
+#endif
+
+// highest NUMA node number + 1 that can be bound to
+#define FIFO_BUFFER_MEMORY_MAX_NODES 1024
+
+// Node the calling thread is running on, 0 where it cannot be told.
+int fifo_buffer_memory_current_node(void);
+
+// Anonymous mapping of at least size bytes. With node >= 0 its pages are bound to that
+// node (mbind MPOL_BIND); they are placed when first touched, so the caller should
+// write the whole region once. *backing asks for huge pages and returns what was
+// obtained: hugetlb falls back to transparent huge pages, which fall back to small
+// pages. NULL if the mapping or the node binding fails.
+void *fifo_buffer_memory_map(size_t size, int node, enum fifo_buffer_page_backing *backing);
+// size and backing as passed to and returned by fifo_buffer_memory_map().
+void fifo_buffer_memory_unmap(void *memory, size_t size, enum fifo_buffer_page_backing backing);
+
+#endif // FIFO_BUFFER_MEMORY_INTERNAL_H
@@ -0,0 +1,248 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fifo_buffer_merge.h"
+#include "fifo_buffer_merge_internal.h"
+
+struct fifo_buffer_merge *fifo_buffer_merge_new(struct fifo_buffer *const *const inputs, const size_t input_count, const fifo_buffer_merge_key key, void *const context)
+{
+    assert(inputs != NULL || input_count == 0);
+    assert(key != NULL);
+
+    if (input_count > SIZE_MAX / sizeof(struct fifo_buffer_merge_node)) {
+        return NULL;
+    }
+
+    const size_t allocated = input_count > 0 ? input_count : 1;
+    struct fifo_buffer_merge *const self = malloc(sizeof(struct fifo_buffer_merge));
+    struct fifo_buffer **const copied = malloc(allocated * sizeof(struct fifo_buffer *));
+    struct fifo_buffer_merge_node *const heap = malloc(allocated * sizeof(struct fifo_buffer_merge_node));
+    size_t *const idle = malloc(allocated * sizeof(size_t));
+    if (self == NULL || copied == NULL || heap == NULL || idle == NULL) {
+        free(idle);
+        free(heap);
+        free(copied);
+        free(self);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < input_count; i++) {
+        copied[i] = inputs[i];
+        idle[i] = i;
+    }
+    *self = (struct fifo_buffer_merge){
+        .inputs = copied,
+        .input_count = input_count,
+        .key = key,
+        .context = context,
+        .watermark = 0,
+        .heap = heap,
+        .heap_size = 0,
+        .idle = idle,
+        .idle_count = input_count,
+        .polled_watermark = 0,
+    };
+    return self;
+}
+
+void fifo_buffer_merge_delete(struct fifo_buffer_merge *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    free(self->idle);
+    free(self->heap);
+    free(self->inputs);
+    free(self);
+}
+
+void fifo_buffer_merge_advance_watermark(struct fifo_buffer_merge *const self, const uint64_t watermark)
+{
+    assert(self != NULL);
+
+    if (watermark > self->watermark) {
+        self->watermark = watermark;
+    }
+}
+
+uint64_t fifo_buffer_merge_watermark(const struct fifo_buffer_merge *const self)
+{
+    assert(self != NULL);
+    return self->watermark;
+}
+
+static inline bool precedes(const struct fifo_buffer_merge_node *const a, const struct fifo_buffer_merge_node *const b)
+{
+    return a->key < b->key || (a->key == b->key && a->input < b->input);
+}
+
+static void sift_up(struct fifo_buffer_merge *const self, size_t position)
+{
+    const struct fifo_buffer_merge_node node = self->heap[position];
+    while (position > 0) {
+        const size_t parent = (position - 1) / 2;
+        if (!precedes(&node, &self->heap[parent])) {
+            break;
+        }
+        self->heap[position] = self->heap[parent];
+        position = parent;
+    }
+    self->heap[position] = node;
+}
+
+static void sift_down(struct fifo_buffer_merge *const self, size_t position)
+{
+    const struct fifo_buffer_merge_node node = self->heap[position];
+    for (;;) {
+        size_t child = 2 * position + 1;
+        if (child >= self->heap_size) {
+            break;
+        }
+        if (child + 1 < self->heap_size && precedes(&self->heap[child + 1], &self->heap[child])) {
+            child++;
+        }
+        if (!precedes(&self->heap[child], &node)) {
+            break;
+        }
+        self->heap[position] = self->heap[child];
+        position = child;
+    }
+    self->heap[position] = node;
+}
+
+// Key of input's head, false when it has none.
+static bool head_key(const struct fifo_buffer_merge *const self, const size_t input, uint64_t *const key)
+{
+    const struct fifo_buffer *const buffer = self->inputs[input];
+    const void *const head = buffer->vptr->peek(buffer);
+    if (head == NULL) {
+        return false;
+    }
+
+    *key = self->key(head, buffer->vptr->peek_size(buffer), self->context);
+    return true;
+}
+
+// Moves idle inputs that have a head now into the heap.
+static void poll_idle(struct fifo_buffer_merge *const self)
+{
+    self->polled_watermark = self->watermark;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < self->idle_count; i++) {
+        const size_t input = self->idle[i];
+        uint64_t key = 0;
+        if (!head_key(self, input, &key)) {
+            self->idle[kept++] = input;
+            continue;
+        }
+
+        self->heap[self->heap_size] = (struct fifo_buffer_merge_node){ .key = key, .input = input };
+        sift_up(self, self->heap_size++);
+    }
+    self->idle_count = kept;
+}
+
+// Input whose head goes next, or SIZE_MAX when nothing may be emitted yet.
+static size_t next_input(struct fifo_buffer_merge *const self)
+{
+    // Heads that showed up on idle inputs since the last poll were produced after that
+    // watermark, so a top below it goes first without peeking every idle input again.
+    if (self->heap_size == 0 || self->heap[0].key >= self->polled_watermark) {
+        poll_idle(self);
+    }
+    if (self->heap_size == 0) {
+        return SIZE_MAX;
+    }
+
+    // an idle input could still produce anything above the watermark
+    const struct fifo_buffer_merge_node *const top = &self->heap[0];
+    if (self->idle_count > 0 && top->key > self->watermark) {
+        return SIZE_MAX;
+    }
+    return top->input;
+}
+
+// Reinserts the input at the top of the heap after its head was dequeued.
+static void advance(struct fifo_buffer_merge *const self)
+{
+    const size_t input = self->heap[0].input;
+    uint64_t key = 0;
+    if (head_key(self, input, &key)) {
+        self->heap[0].key = key;
+    } else {
+        self->idle[self->idle_count++] = input;
+        self->heap[0] = self->heap[--self->heap_size];
+        if (self->heap_size == 0) {
+            return;
+        }
+    }
+    sift_down(self, 0);
+}
+
+const void *fifo_buffer_merge_peek(struct fifo_buffer_merge *const self, size_t *const size, size_t *const input)
+{
+    assert(self != NULL);
+
+    const size_t next = next_input(self);
+    if (next == SIZE_MAX) {
+        return NULL;
+    }
+
+    const struct fifo_buffer *const buffer = self->inputs[next];
+    if (size != NULL) {
+        *size = buffer->vptr->peek_size(buffer);
+    }
+    if (input != NULL) {
+        *input = next;
+    }
+    return buffer->vptr->peek(buffer);
+}
+
+bool fifo_buffer_merge_dequeue_default(struct fifo_buffer_merge *const self, void *const element)
+{
+    return fifo_buffer_merge_dequeue(self, element, memcpy);
+}
+
+bool fifo_buffer_merge_dequeue(struct fifo_buffer_merge *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    const size_t next = next_input(self);
+    if (next == SIZE_MAX) {
+        return false;
+    }
+
+    // the head was peeked and only this consumer dequeues, so it is still there
+    struct fifo_buffer *const buffer = self->inputs[next];
+    const bool dequeued = buffer->vptr->dequeue(buffer, element, copy);
+    assert(dequeued);
+    advance(self);
+    return dequeued;
+}
+
+size_t fifo_buffer_merge_dequeue_bulk(struct fifo_buffer_merge *const self, void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    uint8_t *const dest = (uint8_t *)elements;
+    size_t transferred = 0;
+    while (transferred < count) {
+        const size_t next = next_input(self);
+        if (next == SIZE_MAX) {
+            break;
+        }
+
+        // through the input's dequeue_bulk, which copies at most size bytes of its head
+        struct fifo_buffer *const buffer = self->inputs[next];
+        const size_t dequeued = buffer->vptr->dequeue_bulk(buffer, dest != NULL ? dest + transferred * size : NULL, size, 1, copy);
+        assert(dequeued == 1);
+        advance(self);
+        transferred += dequeued;
+    }
+    return transferred;
+}
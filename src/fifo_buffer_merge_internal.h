@@ -0,0 +1,33 @@
+#ifndef FIFO_BUFFER_MERGE_INTERNAL_H
+#define FIFO_BUFFER_MERGE_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fifo_buffer.h"
+#include "fifo_buffer_merge.h"
+
+struct fifo_buffer_merge_node {
+    uint64_t key;
+    size_t input;
+};
+
+struct fifo_buffer_merge {
+    struct fifo_buffer **inputs;
+    size_t input_count;
+    fifo_buffer_merge_key key;
+    void *context;
+    uint64_t watermark;
+
+    // inputs with a head, smallest key first; ties go to the lower input index
+    struct fifo_buffer_merge_node *heap;
+    size_t heap_size;
+    // inputs found empty when last looked at, polled again before an emission unless
+    // the top of the heap is below polled_watermark
+    size_t *idle;
+    size_t idle_count;
+    // watermark when idle was last polled; anything queued on an idle input since is at least this
+    uint64_t polled_watermark;
+};
+
+#endif // FIFO_BUFFER_MERGE_INTERNAL_H
@@ -0,0 +1,34 @@
+#include <assert.h>
+
+#include "fifo_buffer_stats_internal.h"
+
+#if defined(FIFO_BUFFER_STATS)
+void fifo_buffer_stats_collect(const struct fifo_buffer_producer_stats *const producer, const struct fifo_buffer_consumer_stats *const consumer, struct fifo_buffer_stats *const stats)
+{
+    assert(producer != NULL);
+    assert(consumer != NULL);
+    assert(stats != NULL);
+
+    *stats = (struct fifo_buffer_stats){
+        .enqueued = atomic_load_explicit(&producer->enqueued, memory_order_relaxed),
+        .dequeued = atomic_load_explicit(&consumer->dequeued, memory_order_relaxed),
+        .full_rejects = atomic_load_explicit(&producer->full_rejects, memory_order_relaxed),
+        .empty_polls = atomic_load_explicit(&consumer->empty_polls, memory_order_relaxed),
+        .high_water_mark = atomic_load_explicit(&producer->high_water_mark, memory_order_relaxed),
+    };
+    const size_t consumer_high_water_mark = atomic_load_explicit(&consumer->high_water_mark, memory_order_relaxed);
+    if (consumer_high_water_mark > stats->high_water_mark) {
+        stats->high_water_mark = consumer_high_water_mark;
+    }
+    for (size_t i = 0; i < FIFO_BUFFER_STATS_SIZE_BUCKETS; i++) {
+        stats->size_histogram[i] = atomic_load_explicit(&producer->size_histogram[i], memory_order_relaxed);
+    }
+}
+#endif
+
+bool fifo_buffer_stats_unavailable(const struct fifo_buffer *const self, struct fifo_buffer_stats *const stats)
+{
+    (void)self;
+    (void)stats;
+    return false;
+}
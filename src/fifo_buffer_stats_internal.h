@@ -0,0 +1,66 @@
+#ifndef FIFO_BUFFER_STATS_INTERNAL_H
+#define FIFO_BUFFER_STATS_INTERNAL_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fifo_buffer.h"
+#include "fifo_buffer_stats.h"
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L
+#error "This library requires ISO/IEC 9899:2011 conformance environment to build."
+#endif
+
+#if defined(FIFO_BUFFER_STATS)
+
+// Each counter block is only ever written by one side at a time, so a relaxed
+// load/store pair is enough and no locked instruction is needed.
+static inline void fifo_buffer_stats_add(atomic_uint_fast64_t *const counter, const uint_fast64_t value)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+static inline void fifo_buffer_stats_record_occupancy(atomic_size_t *const high_water_mark, const size_t occupancy)
+{
+    if (occupancy > atomic_load_explicit(high_water_mark, memory_order_relaxed)) {
+        atomic_store_explicit(high_water_mark, occupancy, memory_order_relaxed);
+    }
+}
+
+static inline void fifo_buffer_stats_record_enqueue(struct fifo_buffer_producer_stats *const self, const size_t size, const size_t count)
+{
+    size_t bucket = 0;
+    for (size_t value = size; value != 0 && bucket < FIFO_BUFFER_STATS_SIZE_BUCKETS - 1; value >>= 1) {
+        bucket++;
+    }
+
+    fifo_buffer_stats_add(&self->enqueued, count);
+    fifo_buffer_stats_add(&self->size_histogram[bucket], count);
+}
+
+#define FIFO_BUFFER_STATS_ADD(counter, value) fifo_buffer_stats_add(&(counter), (value))
+#define FIFO_BUFFER_STATS_ADD_SHARED(counter, value) ((void)atomic_fetch_add_explicit(&(counter), (value), memory_order_relaxed))
+#define FIFO_BUFFER_STATS_RECORD_ENQUEUE(stats, size, count) fifo_buffer_stats_record_enqueue(&(stats), (size), (count))
+// only call where the other side's index was just re-read, a cached one can be far behind
+#define FIFO_BUFFER_STATS_RECORD_OCCUPANCY(high_water_mark, occupancy) fifo_buffer_stats_record_occupancy(&(high_water_mark), (occupancy))
+
+#else
+
+// compiled out: arguments are not evaluated and the counters do not exist
+#define FIFO_BUFFER_STATS_ADD(counter, value) ((void)0)
+#define FIFO_BUFFER_STATS_ADD_SHARED(counter, value) ((void)0)
+#define FIFO_BUFFER_STATS_RECORD_ENQUEUE(stats, size, count) ((void)0)
+#define FIFO_BUFFER_STATS_RECORD_OCCUPANCY(high_water_mark, occupancy) ((void)0)
+
+#endif // FIFO_BUFFER_STATS
+
+#if defined(FIFO_BUFFER_STATS)
+void fifo_buffer_stats_collect(const struct fifo_buffer_producer_stats *producer, const struct fifo_buffer_consumer_stats *consumer, struct fifo_buffer_stats *stats);
+#endif
+
+// stats_snapshot() of buffers that do not collect statistics
+bool fifo_buffer_stats_unavailable(const struct fifo_buffer *self, struct fifo_buffer_stats *stats);
+
+#endif // FIFO_BUFFER_STATS_INTERNAL_H
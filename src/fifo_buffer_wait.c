@@ -0,0 +1,146 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+#include "fifo_buffer_wait_internal.h"
+
+atomic_bool fifo_buffer_wait_asymmetric_barrier;
+
+static pthread_once_t asymmetric_barrier_once = PTHREAD_ONCE_INIT;
+
+// Only ever flips the flag from false to true, and a notifier that still reads false
+// just fences, so the flag needs no ordering of its own.
+static void register_asymmetric_barrier(void)
+{
+#if defined(__linux__) && defined(SYS_membarrier)
+    if (syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0) {
+        atomic_store_explicit(&fifo_buffer_wait_asymmetric_barrier, true, memory_order_relaxed);
+    }
+#endif
+}
+
+// Full barrier on the parking side that also covers notifiers running without one.
+static void heavy_barrier(void)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+#if defined(__linux__) && defined(SYS_membarrier)
+    if (atomic_load_explicit(&fifo_buffer_wait_asymmetric_barrier, memory_order_relaxed)) {
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+    }
+#endif
+}
+
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static inline bool deadline_passed(const struct timespec *const deadline)
+{
+    if (deadline == NULL) {
+        return false;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+// Sleeps while epoch still equals expected. Returns false once the deadline passed.
+static bool park(atomic_uint *const epoch, const unsigned expected, const struct timespec *const deadline)
+{
+#if defined(__linux__)
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC timeout, unlike plain FUTEX_WAIT
+    const long result = syscall(SYS_futex, (uint32_t *)epoch, FUTEX_WAIT_BITSET_PRIVATE, expected, deadline, NULL, FUTEX_BITSET_MATCH_ANY);
+    return !(result == -1 && errno == ETIMEDOUT);
+#else
+    (void)epoch;
+    (void)expected;
+    sched_yield();
+    return !deadline_passed(deadline);
+#endif
+}
+
+void fifo_buffer_wait_point_initialize(struct fifo_buffer_wait_point *const self)
+{
+    assert(self != NULL);
+
+    atomic_init(&self->epoch, 0);
+    atomic_init(&self->waiters, 0);
+
+    // registering up front lets notifiers skip their fence before anybody waits
+    pthread_once(&asymmetric_barrier_once, register_asymmetric_barrier);
+}
+
+void fifo_buffer_wait_point_wake_all(struct fifo_buffer_wait_point *const self)
+{
+    assert(self != NULL);
+
+    atomic_fetch_add_explicit(&self->epoch, 1, memory_order_release);
+#if defined(__linux__)
+    syscall(SYS_futex, (uint32_t *)&self->epoch, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+bool fifo_buffer_wait_point_wait(struct fifo_buffer_wait_point *const self, bool (*const attempt)(void *), void *const context, const atomic_bool *const closed, const unsigned spin_budget, const struct timespec *const deadline)
+{
+    assert(self != NULL);
+    assert(attempt != NULL);
+
+    for (unsigned i = 0; i < spin_budget; i++) {
+        if (attempt(context)) {
+            return true;
+        }
+        if (atomic_load_explicit(closed, memory_order_acquire)) {
+            return false;
+        }
+        cpu_relax();
+    }
+
+    // after this the flag is final, so the barrier below matches what notifiers do
+    pthread_once(&asymmetric_barrier_once, register_asymmetric_barrier);
+
+    for (;;) {
+        const unsigned epoch = atomic_load_explicit(&self->epoch, memory_order_acquire);
+        atomic_fetch_add_explicit(&self->waiters, 1, memory_order_relaxed);
+        heavy_barrier();
+
+        // re-check after announcing ourselves, so a notify that raced with us is not lost
+        const bool done = attempt(context);
+        const bool stop = done || atomic_load_explicit(closed, memory_order_acquire);
+        const bool in_time = stop || park(&self->epoch, epoch, deadline);
+
+        atomic_fetch_sub_explicit(&self->waiters, 1, memory_order_relaxed);
+        if (done) {
+            return true;
+        }
+        if (stop) {
+            return false;
+        }
+        if (!in_time || deadline_passed(deadline)) {
+            return attempt(context);
+        }
+    }
+}
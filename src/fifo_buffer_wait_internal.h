@@ -0,0 +1,22 @@
+#ifndef FIFO_BUFFER_WAIT_INTERNAL_H
+#define FIFO_BUFFER_WAIT_INTERNAL_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "fifo_buffer_wait.h"
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L
+#error "This library requires ISO/IEC 9899:2011 conformance environment to build."
+#endif
+
+#define FIFO_BUFFER_WAIT_DEFAULT_SPIN_BUDGET 1024U
+
+void fifo_buffer_wait_point_initialize(struct fifo_buffer_wait_point *self);
+
+// Retries attempt(context) until it succeeds, *closed becomes true or deadline
+// (CLOCK_MONOTONIC, NULL for none) passes. Spins spin_budget times before parking.
+bool fifo_buffer_wait_point_wait(struct fifo_buffer_wait_point *self, bool (*attempt)(void *context), void *context, const atomic_bool *closed, unsigned spin_budget, const struct timespec *deadline);
+
+#endif // FIFO_BUFFER_WAIT_INTERNAL_H
@@ -1,4 +1,6 @@
 #include <assert.h>
+#include <limits.h>
+#include <stddef.h>
 #include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -17,61 +19,120 @@ static const struct fifo_buffer_interface vtable = {
     .enqueue = lockfree_fifo_buffer_enqueue,
     .dequeue_default = lockfree_fifo_buffer_dequeue_default,
     .dequeue = lockfree_fifo_buffer_dequeue,
+    .enqueue_bulk = lockfree_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = lockfree_fifo_buffer_dequeue_bulk,
     .peek = lockfree_fifo_buffer_peek,
     .peek_size = lockfree_fifo_buffer_peek_size,
     .is_empty = lockfree_fifo_buffer_is_empty,
     .is_full = lockfree_fifo_buffer_is_full,
+    .stats_snapshot = lockfree_fifo_buffer_stats_snapshot,
 };
 
 #if !defined(__has_builtin)
 #define __has_builtin(x) 0
 #endif
 
-static inline uint_fast64_t calc_aligned_capacity(const uint_fast64_t number)
+// smallest power of two >= number; SIZE_MAX when there is none, which the caller rejects
+static inline size_t calc_aligned_capacity(const size_t number)
 {
-#if __has_builtin(__builtin_clzll)
-    if (number == 0) {
-        return 0;
+    if (number <= 1) {
+        return number;
     }
-    return 1ULL << (63 - __builtin_clzll(number) + 1);
+    if (number > SIZE_MAX / 2 + 1) {
+        return SIZE_MAX;
+    }
+#if __has_builtin(__builtin_clzll)
+    return (size_t)1 << (64 - __builtin_clzll((unsigned long long)(number - 1)));
 #else
-    uint_fast64_t value = number;
-    value = (value & 0xFFFFFFFF00000000ULL) ? (value & 0xFFFFFFFF00000000ULL) : value;
-    value = (value & 0xFFFF0000FFFF0000ULL) ? (value & 0xFFFF0000FFFF0000ULL) : value;
-    value = (value & 0xFF00FF00FF00FF00ULL) ? (value & 0xFF00FF00FF00FF00ULL) : value;
-    value = (value & 0xF0F0F0F0F0F0F0F0ULL) ? (value & 0xF0F0F0F0F0F0F0F0ULL) : value;
-    value = (value & 0xCCCCCCCCCCCCCCCCULL) ? (value & 0xCCCCCCCCCCCCCCCCULL) : value;
-    value = (value & 0xAAAAAAAAAAAAAAAAULL) ? (value & 0xAAAAAAAAAAAAAAAAULL) : value;
-    return value << 1;
+    size_t value = number - 1;
+    for (size_t shift = 1; shift < sizeof(size_t) * CHAR_BIT; shift <<= 1) {
+        value |= value >> shift;
+    }
+    return value + 1;
 #endif
 }
 
+static inline size_t round_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// options with defaults filled in and the current node looked up
+static struct lockfree_fifo_buffer_options resolve_options(const struct lockfree_fifo_buffer_options *const options)
+{
+    struct lockfree_fifo_buffer_options resolved = {
+        .numa_policy = LOCKFREE_FIFO_BUFFER_NUMA_FIRST_TOUCH,
+        .numa_node = -1,
+        .pages = FIFO_BUFFER_PAGES_SMALL,
+    };
+    if (options != NULL) {
+        resolved = *options;
+    }
+    if (resolved.numa_policy == LOCKFREE_FIFO_BUFFER_NUMA_CURRENT_NODE) {
+        resolved.numa_policy = LOCKFREE_FIFO_BUFFER_NUMA_NODE;
+        resolved.numa_node = fifo_buffer_memory_current_node();
+    }
+    if (resolved.numa_policy != LOCKFREE_FIFO_BUFFER_NUMA_NODE) {
+        resolved.numa_node = -1;
+    }
+    return resolved;
+}
+
+static inline size_t calc_storage_size(const size_t capacity, const size_t element_stride)
+{
+    return round_up(capacity * element_stride, LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE);
+}
+
 bool lockfree_fifo_buffer_initialize(struct lockfree_fifo_buffer *const self, const size_t element_size, const size_t count)
+{
+    return lockfree_fifo_buffer_initialize_with_options(self, element_size, count, NULL);
+}
+
+bool lockfree_fifo_buffer_initialize_with_options(struct lockfree_fifo_buffer *const self, const size_t element_size, const size_t count, const struct lockfree_fifo_buffer_options *const options)
 {
     const size_t aligned_capacity = calc_aligned_capacity(count);
+    const size_t element_stride = round_up(sizeof(struct lockfree_fifo_buffer_element) + element_size, alignof(struct lockfree_fifo_buffer_element));
+    if (aligned_capacity > (SIZE_MAX - LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) / element_stride) {
+        return false;
+    }
+
+    const struct lockfree_fifo_buffer_options resolved = resolve_options(options);
+    if (resolved.numa_policy == LOCKFREE_FIFO_BUFFER_NUMA_NODE && resolved.numa_node < 0) {
+        return false;
+    }
+
+    const size_t storage_size = calc_storage_size(aligned_capacity, element_stride);
+    const bool storage_mapped = resolved.numa_node >= 0 || resolved.pages != FIFO_BUFFER_PAGES_SMALL;
+    enum fifo_buffer_page_backing page_backing = resolved.pages;
+    uint8_t *const buffer = storage_mapped ? (uint8_t *)fifo_buffer_memory_map(storage_size, resolved.numa_node, &page_backing)
+                                           : (uint8_t *)aligned_alloc(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE, storage_size > 0 ? storage_size : LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE);
     struct lockfree_fifo_buffer tmp = {
         .parent = { .vptr = &vtable },
         .element_size = element_size,
         .capacity = aligned_capacity,
-        .buffer = (struct buffer_element **)calloc(aligned_capacity, sizeof(struct buffer_element *)),
+        .element_stride = element_stride,
+        .buffer = buffer,
+        .spin_budget = FIFO_BUFFER_WAIT_DEFAULT_SPIN_BUDGET,
+        .numa_node = resolved.numa_node,
+        .page_backing = page_backing,
+        .storage_mapped = storage_mapped,
+        .cached_read_index = 0,
+        .cached_write_index = 0,
     };
 
-    atomic_init(&tmp.read_index, aligned_capacity - 1);
-    atomic_init(&tmp.write_index, aligned_capacity - 1);
+    atomic_init(&tmp.read_index, 0);
+    atomic_init(&tmp.write_index, 0);
+    atomic_init(&tmp.closed, false);
+    fifo_buffer_wait_point_initialize(&tmp.not_empty);
+    fifo_buffer_wait_point_initialize(&tmp.not_full);
 
     if (tmp.buffer == NULL) {
         return false;
     }
 
+    // also faults every page in, which places bound storage on its node
     for (size_t i = 0; i < tmp.capacity; i++) {
-        struct buffer_element *const element = (struct buffer_element *)malloc(sizeof(struct buffer_element) + tmp.element_size);
-        if (element == NULL) {
-            lockfree_fifo_buffer_dispose((struct fifo_buffer *)&tmp);
-            return false;
-        }
-
-        element->size = 0;
-        tmp.buffer[i] = element;
+        lockfree_fifo_buffer_element_at(&tmp, i)->size = 0;
     }
 
     *(struct lockfree_fifo_buffer *)self = tmp;
@@ -80,16 +141,31 @@ bool lockfree_fifo_buffer_initialize(struct lockfree_fifo_buffer *const self, co
 
 struct lockfree_fifo_buffer *lockfree_fifo_buffer_new(const size_t element_size, const size_t count)
 {
-    struct lockfree_fifo_buffer *const buf = malloc(sizeof(struct lockfree_fifo_buffer));
+    return lockfree_fifo_buffer_new_with_options(element_size, count, NULL);
+}
+
+struct lockfree_fifo_buffer *lockfree_fifo_buffer_new_with_options(const size_t element_size, const size_t count, const struct lockfree_fifo_buffer_options *const options)
+{
+    // resolve once so that the buffer and its storage end up on the same node
+    const struct lockfree_fifo_buffer_options resolved = resolve_options(options);
+    const bool mapped = resolved.numa_node >= 0;
+    enum fifo_buffer_page_backing small = FIFO_BUFFER_PAGES_SMALL;
+    struct lockfree_fifo_buffer *const buf = mapped ? fifo_buffer_memory_map(sizeof(struct lockfree_fifo_buffer), resolved.numa_node, &small)
+                                                    : aligned_alloc(alignof(struct lockfree_fifo_buffer), sizeof(struct lockfree_fifo_buffer));
     if (buf == NULL) {
         return NULL;
     }
 
-    if (!lockfree_fifo_buffer_initialize(buf, element_size, count)) {
-        free(buf);
+    if (!lockfree_fifo_buffer_initialize_with_options(buf, element_size, count, &resolved)) {
+        if (mapped) {
+            fifo_buffer_memory_unmap(buf, sizeof(struct lockfree_fifo_buffer), FIFO_BUFFER_PAGES_SMALL);
+        } else {
+            free(buf);
+        }
         return NULL;
     }
 
+    buf->mapped = mapped;
     return buf;
 }
 
@@ -98,15 +174,19 @@ void lockfree_fifo_buffer_dispose(struct fifo_buffer *const self)
     assert(self != NULL);
     struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
 
-    for (size_t i = 0; i < _self->capacity; i++) {
-        free(_self->buffer[i]);
+    if (_self->storage_mapped) {
+        fifo_buffer_memory_unmap(_self->buffer, calc_storage_size(_self->capacity, _self->element_stride), _self->page_backing);
+    } else {
+        free(_self->buffer);
     }
-    free(_self->buffer);
     *_self = (struct lockfree_fifo_buffer){
         .parent = { .vptr = NULL },
         .capacity = 0,
         .element_size = 0,
+        .element_stride = 0,
         .buffer = NULL,
+        .numa_node = -1,
+        .mapped = _self->mapped,
     };
 }
 
@@ -117,7 +197,23 @@ void lockfree_fifo_buffer_delete(struct fifo_buffer *const self)
     }
 
     lockfree_fifo_buffer_dispose(self);
-    free(self);
+    if (((struct lockfree_fifo_buffer *)self)->mapped) {
+        fifo_buffer_memory_unmap(self, sizeof(struct lockfree_fifo_buffer), FIFO_BUFFER_PAGES_SMALL);
+    } else {
+        free(self);
+    }
+}
+
+int lockfree_fifo_buffer_numa_node(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return ((const struct lockfree_fifo_buffer *)self)->numa_node;
+}
+
+enum fifo_buffer_page_backing lockfree_fifo_buffer_page_backing(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return ((const struct lockfree_fifo_buffer *)self)->page_backing;
 }
 
 size_t lockfree_fifo_buffer_capacity(const struct fifo_buffer *const self)
@@ -131,9 +227,11 @@ size_t lockfree_fifo_buffer_count(const struct fifo_buffer *const self)
     assert(self != NULL);
 
     const struct lockfree_fifo_buffer *const _self = (const struct lockfree_fifo_buffer *)self;
+    // read first: both only grow, so the difference cannot go negative
     const size_t read_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
     const size_t write_index = atomic_load_explicit(&_self->write_index, memory_order_acquire);
-    return write_index >= read_index ? write_index - read_index : _self->capacity - read_index + write_index;
+    const size_t count = write_index - read_index;
+    return count < _self->capacity ? count : _self->capacity;
 }
 
 bool lockfree_fifo_buffer_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
@@ -148,18 +246,24 @@ bool lockfree_fifo_buffer_enqueue(struct fifo_buffer *const self, const void *co
     struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
     assert(_self->buffer != NULL);
 
-    if (lockfree_fifo_buffer_is_full(self)) {
-        return false;
-    }
+    const size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
 
-    const size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_acquire);
-    const size_t next_index = lockfree_fifo_buffer_next_index(self, current_index);
+    if (current_index - _self->cached_read_index >= _self->capacity) {
+        _self->cached_read_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
+        if (current_index - _self->cached_read_index >= _self->capacity) {
+            FIFO_BUFFER_STATS_ADD(_self->producer_stats.full_rejects, 1);
+            return false;
+        }
+    }
 
-    struct buffer_element *const dest = _self->buffer[current_index];
+    struct lockfree_fifo_buffer_element *const dest = lockfree_fifo_buffer_element_at(_self, current_index);
     copy(dest->buffer, element, size);
     dest->size = size;
 
-    atomic_store_explicit(&_self->write_index, next_index, memory_order_release);
+    atomic_store_explicit(&_self->write_index, current_index + 1, memory_order_release);
+    FIFO_BUFFER_STATS_RECORD_ENQUEUE(_self->producer_stats, size, 1);
+
+    fifo_buffer_wait_point_notify(&_self->not_empty);
     return true;
 }
 
@@ -175,22 +279,194 @@ bool lockfree_fifo_buffer_dequeue(struct fifo_buffer *const self, void *const el
     struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
     assert(_self->buffer != NULL);
 
-    if (lockfree_fifo_buffer_is_empty(self)) {
-        return false;
+    const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+    if (current_index == _self->cached_write_index) {
+        _self->cached_write_index = atomic_load_explicit(&_self->write_index, memory_order_acquire);
+        if (current_index == _self->cached_write_index) {
+            FIFO_BUFFER_STATS_ADD(_self->consumer_stats.empty_polls, 1);
+            return false;
+        }
+        FIFO_BUFFER_STATS_RECORD_OCCUPANCY(_self->consumer_stats.high_water_mark, _self->cached_write_index - current_index);
     }
 
-    const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
-    const size_t next_index = lockfree_fifo_buffer_next_index(self, current_index);
-
     if (element != NULL && copy != NULL) {
-        struct buffer_element *const src = _self->buffer[current_index];
+        struct lockfree_fifo_buffer_element *const src = lockfree_fifo_buffer_element_at(_self, current_index);
         copy(element, src->buffer, src->size);
     }
 
-    atomic_store_explicit(&_self->read_index, next_index, memory_order_release);
+    atomic_store_explicit(&_self->read_index, current_index + 1, memory_order_release);
+    FIFO_BUFFER_STATS_ADD(_self->consumer_stats.dequeued, 1);
+
+    fifo_buffer_wait_point_notify(&_self->not_full);
     return true;
 }
 
+void *lockfree_fifo_buffer_reserve(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+
+    if (current_index - _self->cached_read_index >= _self->capacity) {
+        _self->cached_read_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
+        if (current_index - _self->cached_read_index >= _self->capacity) {
+            FIFO_BUFFER_STATS_ADD(_self->producer_stats.full_rejects, 1);
+            return NULL;
+        }
+    }
+
+    return lockfree_fifo_buffer_element_at(_self, current_index)->buffer;
+}
+
+void lockfree_fifo_buffer_commit(struct fifo_buffer *const self, const size_t size)
+{
+    assert(self != NULL);
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+    assert(size <= _self->element_size);
+
+    const size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+    assert(current_index - _self->cached_read_index < _self->capacity);
+
+    lockfree_fifo_buffer_element_at(_self, current_index)->size = size;
+    atomic_store_explicit(&_self->write_index, current_index + 1, memory_order_release);
+    FIFO_BUFFER_STATS_RECORD_ENQUEUE(_self->producer_stats, size, 1);
+    fifo_buffer_wait_point_notify(&_self->not_empty);
+}
+
+const void *lockfree_fifo_buffer_acquire(struct fifo_buffer *const self, size_t *const size)
+{
+    const void *element = NULL;
+    if (lockfree_fifo_buffer_acquire_n(self, &element, size, 1) == 0) {
+        return NULL;
+    }
+
+    return element;
+}
+
+size_t lockfree_fifo_buffer_acquire_n(struct fifo_buffer *const self, const void **const elements, size_t *const sizes, const size_t count)
+{
+    assert(self != NULL);
+    assert(elements != NULL);
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+
+    size_t available = _self->cached_write_index - current_index;
+    if (available < count) {
+        _self->cached_write_index = atomic_load_explicit(&_self->write_index, memory_order_acquire);
+        available = _self->cached_write_index - current_index;
+        FIFO_BUFFER_STATS_RECORD_OCCUPANCY(_self->consumer_stats.high_water_mark, available);
+    }
+
+    const size_t acquired = available < count ? available : count;
+    if (acquired == 0 && count > 0) {
+        FIFO_BUFFER_STATS_ADD(_self->consumer_stats.empty_polls, 1);
+    }
+    for (size_t i = 0; i < acquired; i++) {
+        const struct lockfree_fifo_buffer_element *const src = lockfree_fifo_buffer_element_at(_self, current_index + i);
+        elements[i] = src->buffer;
+        if (sizes != NULL) {
+            sizes[i] = src->size;
+        }
+    }
+
+    return acquired;
+}
+
+void lockfree_fifo_buffer_release(struct fifo_buffer *const self, const size_t count)
+{
+    assert(self != NULL);
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+    assert(count <= _self->cached_write_index - current_index);
+
+    atomic_store_explicit(&_self->read_index, current_index + count, memory_order_release);
+    FIFO_BUFFER_STATS_ADD(_self->consumer_stats.dequeued, count);
+
+    fifo_buffer_wait_point_notify(&_self->not_full);
+}
+
+size_t lockfree_fifo_buffer_enqueue_bulk(struct fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+
+    size_t available = _self->capacity - (current_index - _self->cached_read_index);
+    if (available < count) {
+        _self->cached_read_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
+        available = _self->capacity - (current_index - _self->cached_read_index);
+    }
+
+    const size_t transferred = available < count ? available : count;
+    const uint8_t *const src = (const uint8_t *)elements;
+    for (size_t i = 0; i < transferred; i++) {
+        struct lockfree_fifo_buffer_element *const dest = lockfree_fifo_buffer_element_at(_self, current_index + i);
+        copy(dest->buffer, src + i * size, size);
+        dest->size = size;
+    }
+
+    if (transferred < count) {
+        FIFO_BUFFER_STATS_ADD(_self->producer_stats.full_rejects, 1);
+    }
+    if (transferred > 0) {
+        atomic_store_explicit(&_self->write_index, current_index + transferred, memory_order_release);
+        FIFO_BUFFER_STATS_RECORD_ENQUEUE(_self->producer_stats, size, transferred);
+        fifo_buffer_wait_point_notify(&_self->not_empty);
+    }
+    return transferred;
+}
+
+size_t lockfree_fifo_buffer_dequeue_bulk(struct fifo_buffer *const self, void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+
+    size_t available = _self->cached_write_index - current_index;
+    if (available < count) {
+        _self->cached_write_index = atomic_load_explicit(&_self->write_index, memory_order_acquire);
+        available = _self->cached_write_index - current_index;
+        FIFO_BUFFER_STATS_RECORD_OCCUPANCY(_self->consumer_stats.high_water_mark, available);
+    }
+
+    const size_t transferred = available < count ? available : count;
+    if (elements != NULL && copy != NULL) {
+        uint8_t *const dest = (uint8_t *)elements;
+        for (size_t i = 0; i < transferred; i++) {
+            const struct lockfree_fifo_buffer_element *const src = lockfree_fifo_buffer_element_at(_self, current_index + i);
+            // an element enqueued larger than the caller's stride is truncated, never overruns it
+            copy(dest + i * size, src->buffer, src->size < size ? src->size : size);
+        }
+    }
+
+    if (transferred == 0 && count > 0) {
+        FIFO_BUFFER_STATS_ADD(_self->consumer_stats.empty_polls, 1);
+    }
+    if (transferred > 0) {
+        atomic_store_explicit(&_self->read_index, current_index + transferred, memory_order_release);
+        FIFO_BUFFER_STATS_ADD(_self->consumer_stats.dequeued, transferred);
+        fifo_buffer_wait_point_notify(&_self->not_full);
+    }
+    return transferred;
+}
+
 const void *lockfree_fifo_buffer_peek(const struct fifo_buffer *const self)
 {
     assert(self != NULL);
@@ -203,7 +479,7 @@ const void *lockfree_fifo_buffer_peek(const struct fifo_buffer *const self)
     }
 
     const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
-    return _self->buffer[current_index]->buffer;
+    return lockfree_fifo_buffer_element_at(_self, current_index)->buffer;
 }
 
 size_t lockfree_fifo_buffer_peek_size(const struct fifo_buffer *const self)
@@ -218,7 +494,7 @@ size_t lockfree_fifo_buffer_peek_size(const struct fifo_buffer *const self)
     }
 
     const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
-    return _self->buffer[current_index]->size;
+    return lockfree_fifo_buffer_element_at(_self, current_index)->size;
 }
 
 bool lockfree_fifo_buffer_is_empty(const struct fifo_buffer *const self)
@@ -241,18 +517,118 @@ bool lockfree_fifo_buffer_is_full(const struct fifo_buffer *const self)
     const struct lockfree_fifo_buffer *const _self = (const struct lockfree_fifo_buffer *)self;
     assert(_self->buffer != NULL);
 
-    const size_t write_index = atomic_load_explicit(&_self->write_index, memory_order_acquire);
-    const size_t read_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
-
-    return lockfree_fifo_buffer_next_index(self, write_index) == read_index;
+    return lockfree_fifo_buffer_count(self) == _self->capacity;
 }
 
-size_t lockfree_fifo_buffer_next_index(const struct fifo_buffer *const self, const size_t index)
+bool lockfree_fifo_buffer_stats_snapshot(const struct fifo_buffer *const self, struct fifo_buffer_stats *const stats)
 {
     assert(self != NULL);
+    assert(stats != NULL);
 
+#if defined(FIFO_BUFFER_STATS)
     const struct lockfree_fifo_buffer *const _self = (const struct lockfree_fifo_buffer *)self;
-    assert(_self->buffer != NULL);
+    fifo_buffer_stats_collect(&_self->producer_stats, &_self->consumer_stats, stats);
+    stats->page_backing = _self->page_backing;
+    return true;
+#else
+    (void)self;
+    (void)stats;
+    return false;
+#endif
+}
+
+// Wait points, closed and the spin budget only exist on buffers laid out over struct
+// lockfree_fifo_buffer, which all report their capacity through it.
+static inline bool is_waitable(const struct fifo_buffer *const self)
+{
+    return self->vptr->capacity == lockfree_fifo_buffer_capacity;
+}
+
+struct wait_context {
+    struct fifo_buffer *self;
+    const void *src;
+    void *dest;
+    size_t size;
+    void *(*copy)(void *, const void *, size_t);
+};
 
-    return (index + 1) & (_self->capacity - 1);
+static bool attempt_enqueue(void *const context)
+{
+    struct wait_context *const _context = (struct wait_context *)context;
+    return _context->self->vptr->enqueue(_context->self, _context->src, _context->size, _context->copy);
+}
+
+static bool attempt_dequeue(void *const context)
+{
+    struct wait_context *const _context = (struct wait_context *)context;
+    return _context->self->vptr->dequeue(_context->self, _context->dest, _context->copy);
+}
+
+bool lockfree_fifo_buffer_enqueue_wait(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    return lockfree_fifo_buffer_enqueue_until(self, element, size, copy, NULL);
+}
+
+bool lockfree_fifo_buffer_enqueue_until(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t), const struct timespec *const deadline)
+{
+    assert(self != NULL);
+
+    if (!is_waitable(self)) {
+        return false;
+    }
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    if (atomic_load_explicit(&_self->closed, memory_order_acquire)) {
+        return false;
+    }
+
+    struct wait_context context = { .self = self, .src = element, .size = size, .copy = copy };
+    return fifo_buffer_wait_point_wait(&_self->not_full, attempt_enqueue, &context, &_self->closed, _self->spin_budget, deadline);
+}
+
+bool lockfree_fifo_buffer_dequeue_wait(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    return lockfree_fifo_buffer_dequeue_until(self, element, copy, NULL);
+}
+
+bool lockfree_fifo_buffer_dequeue_until(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t), const struct timespec *const deadline)
+{
+    assert(self != NULL);
+
+    if (!is_waitable(self)) {
+        return false;
+    }
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    struct wait_context context = { .self = self, .dest = element, .copy = copy };
+    return fifo_buffer_wait_point_wait(&_self->not_empty, attempt_dequeue, &context, &_self->closed, _self->spin_budget, deadline);
+}
+
+void lockfree_fifo_buffer_close(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    if (!is_waitable(self)) {
+        return;
+    }
+
+    struct lockfree_fifo_buffer *const _self = (struct lockfree_fifo_buffer *)self;
+    atomic_store_explicit(&_self->closed, true, memory_order_release);
+    fifo_buffer_wait_point_wake_all(&_self->not_empty);
+    fifo_buffer_wait_point_wake_all(&_self->not_full);
+}
+
+bool lockfree_fifo_buffer_is_closed(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return is_waitable(self) && atomic_load_explicit(&((const struct lockfree_fifo_buffer *)self)->closed, memory_order_acquire);
+}
+
+void lockfree_fifo_buffer_set_spin_budget(struct fifo_buffer *const self, const unsigned spin_budget)
+{
+    assert(self != NULL);
+
+    if (is_waitable(self)) {
+        ((struct lockfree_fifo_buffer *)self)->spin_budget = spin_budget;
+    }
 }
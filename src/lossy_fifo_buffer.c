@@ -0,0 +1,337 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "lossy_fifo_buffer.h"
+#include "lossy_fifo_buffer_internal.h"
+
+static const struct fifo_buffer_interface vtable = {
+    .dispose = lossy_fifo_buffer_dispose,
+    .free = lossy_fifo_buffer_delete,
+    .capacity = lossy_fifo_buffer_capacity,
+    .count = lossy_fifo_buffer_count,
+    .enqueue_default = lossy_fifo_buffer_enqueue_default,
+    .enqueue = lossy_fifo_buffer_enqueue,
+    .dequeue_default = lossy_fifo_buffer_dequeue_default,
+    .dequeue = lossy_fifo_buffer_dequeue,
+    .enqueue_bulk = lossy_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = lossy_fifo_buffer_dequeue_bulk,
+    .peek = lossy_fifo_buffer_peek,
+    .peek_size = lossy_fifo_buffer_peek_size,
+    .is_empty = lossy_fifo_buffer_is_empty,
+    .is_full = lossy_fifo_buffer_is_full,
+    .stats_snapshot = lossy_fifo_buffer_stats_snapshot,
+};
+
+static inline size_t calc_capacity(const size_t count)
+{
+    size_t capacity = 1;
+    while (capacity < count) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static inline size_t round_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+struct lossy_fifo_buffer *lossy_fifo_buffer_new(const size_t element_size, const size_t count)
+{
+    if (count > (SIZE_MAX >> 1)) {
+        return NULL;
+    }
+
+    const size_t capacity = calc_capacity(count);
+    const size_t element_stride = round_up(sizeof(struct lossy_element) + element_size, alignof(struct lossy_element));
+    if (capacity > (SIZE_MAX - LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) / element_stride) {
+        return NULL;
+    }
+
+    struct lossy_fifo_buffer *const self = aligned_alloc(alignof(struct lossy_fifo_buffer), sizeof(struct lossy_fifo_buffer));
+    if (self == NULL) {
+        return NULL;
+    }
+
+    uint8_t *const buffer = (uint8_t *)aligned_alloc(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE, round_up(capacity * element_stride, LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE));
+    if (buffer == NULL) {
+        free(self);
+        return NULL;
+    }
+
+    *self = (struct lossy_fifo_buffer){
+        .parent = { .vptr = &vtable },
+        .element_size = element_size,
+        .capacity = capacity,
+        .element_stride = element_stride,
+        .buffer = buffer,
+    };
+    atomic_init(&self->write_index, 0);
+    atomic_init(&self->read_index, 0);
+    atomic_init(&self->overwritten, 0);
+
+    for (size_t i = 0; i < capacity; i++) {
+        struct lossy_element *const element = lossy_fifo_buffer_element_at(self, i);
+        atomic_init(&element->sequence, 0);
+        atomic_init(&element->size, 0);
+    }
+
+    return self;
+}
+
+void lossy_fifo_buffer_dispose(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    struct lossy_fifo_buffer *const _self = (struct lossy_fifo_buffer *)self;
+
+    free(_self->buffer);
+    _self->parent.vptr = NULL;
+    _self->capacity = 0;
+    _self->element_size = 0;
+    _self->element_stride = 0;
+    _self->buffer = NULL;
+}
+
+void lossy_fifo_buffer_delete(struct fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    lossy_fifo_buffer_dispose(self);
+    free(self);
+}
+
+uint64_t lossy_fifo_buffer_overwritten(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return atomic_load_explicit(&((const struct lossy_fifo_buffer *)self)->overwritten, memory_order_relaxed);
+}
+
+size_t lossy_fifo_buffer_capacity(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return ((const struct lossy_fifo_buffer *)self)->capacity;
+}
+
+size_t lossy_fifo_buffer_count(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct lossy_fifo_buffer *const _self = (const struct lossy_fifo_buffer *)self;
+    const size_t read_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
+    const size_t write_index = atomic_load_explicit(&_self->write_index, memory_order_acquire);
+    const size_t count = write_index - read_index;
+    return count < _self->capacity ? count : _self->capacity;
+}
+
+static void put(struct lossy_fifo_buffer *const self, const size_t position, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(size <= self->element_size);
+
+    struct lossy_element *const dest = lossy_fifo_buffer_element_at(self, position);
+    atomic_store_explicit(&dest->sequence, 2 * position + 1, memory_order_relaxed);
+    // keeps the payload writes below from moving above the odd sequence
+    atomic_thread_fence(memory_order_release);
+
+    copy(dest->buffer, element, size);
+    atomic_store_explicit(&dest->size, size, memory_order_relaxed);
+    atomic_store_explicit(&dest->sequence, 2 * position + 2, memory_order_release);
+}
+
+bool lossy_fifo_buffer_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return lossy_fifo_buffer_enqueue(self, element, size, memcpy);
+}
+
+bool lossy_fifo_buffer_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct lossy_fifo_buffer *const _self = (struct lossy_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+    put(_self, current_index, element, size, copy);
+    atomic_store_explicit(&_self->write_index, current_index + 1, memory_order_release);
+    FIFO_BUFFER_STATS_RECORD_ENQUEUE(_self->producer_stats, size, 1);
+    FIFO_BUFFER_STATS_RECORD_OCCUPANCY(_self->producer_stats.high_water_mark, lossy_fifo_buffer_count(self));
+
+    return true;
+}
+
+size_t lossy_fifo_buffer_enqueue_bulk(struct fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct lossy_fifo_buffer *const _self = (struct lossy_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+    const uint8_t *const src = (const uint8_t *)elements;
+    for (size_t i = 0; i < count; i++) {
+        put(_self, current_index + i, src + i * size, size, copy);
+    }
+
+    if (count > 0) {
+        atomic_store_explicit(&_self->write_index, current_index + count, memory_order_release);
+        FIFO_BUFFER_STATS_RECORD_ENQUEUE(_self->producer_stats, size, count);
+        FIFO_BUFFER_STATS_RECORD_OCCUPANCY(_self->producer_stats.high_water_mark, lossy_fifo_buffer_count(self));
+    }
+    return count;
+}
+
+// consumer only, so a relaxed load/store pair is enough
+static void skip_to(struct lossy_fifo_buffer *const self, size_t *const position, const size_t target)
+{
+    const uint_fast64_t overwritten = atomic_load_explicit(&self->overwritten, memory_order_relaxed);
+    atomic_store_explicit(&self->overwritten, overwritten + (target - *position), memory_order_relaxed);
+    *position = target;
+}
+
+// Copies at most size bytes of the oldest intact element into element and consumes it,
+// skipping whatever was overwritten on the way. false when the ring is empty.
+static bool take(struct lossy_fifo_buffer *const self, void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    // a torn size is caught by the sequence check below, but must not overrun the slot or the caller
+    const size_t limit = size < self->element_size ? size : self->element_size;
+    const size_t start = atomic_load_explicit(&self->read_index, memory_order_relaxed);
+    size_t position = start;
+    bool taken = false;
+
+    for (;;) {
+        const size_t write_index = atomic_load_explicit(&self->write_index, memory_order_acquire);
+        if (position == write_index) {
+            break;
+        }
+        if (write_index - position > self->capacity) {
+            skip_to(self, &position, write_index - self->capacity);
+        }
+
+        const struct lossy_element *const src = lossy_fifo_buffer_element_at(self, position);
+        const size_t sequence = atomic_load_explicit(&src->sequence, memory_order_acquire);
+        if (sequence == 2 * position + 2) {
+            if (element != NULL && copy != NULL) {
+                const size_t stored = atomic_load_explicit(&src->size, memory_order_relaxed);
+                copy(element, src->buffer, stored < limit ? stored : limit);
+            }
+            // the copy has to be complete before the sequence is checked again
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&src->sequence, memory_order_relaxed) == sequence) {
+                position++;
+                taken = true;
+                break;
+            }
+        }
+
+        // published before write_index, so any other value means a later lap took the slot
+        skip_to(self, &position, position + 1);
+    }
+
+    if (position != start) {
+        atomic_store_explicit(&self->read_index, position, memory_order_release);
+    }
+    return taken;
+}
+
+bool lossy_fifo_buffer_dequeue_default(struct fifo_buffer *const self, void *const element)
+{
+    return lossy_fifo_buffer_dequeue(self, element, memcpy);
+}
+
+bool lossy_fifo_buffer_dequeue(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct lossy_fifo_buffer *const _self = (struct lossy_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    if (!take(_self, element, _self->element_size, copy)) {
+        FIFO_BUFFER_STATS_ADD(_self->consumer_stats.empty_polls, 1);
+        return false;
+    }
+
+    FIFO_BUFFER_STATS_ADD(_self->consumer_stats.dequeued, 1);
+    return true;
+}
+
+size_t lossy_fifo_buffer_dequeue_bulk(struct fifo_buffer *const self, void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct lossy_fifo_buffer *const _self = (struct lossy_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    uint8_t *const dest = (uint8_t *)elements;
+    size_t transferred = 0;
+    while (transferred < count && take(_self, dest != NULL ? dest + transferred * size : NULL, size, copy)) {
+        transferred++;
+    }
+
+    if (transferred == 0 && count > 0) {
+        FIFO_BUFFER_STATS_ADD(_self->consumer_stats.empty_polls, 1);
+    }
+    FIFO_BUFFER_STATS_ADD(_self->consumer_stats.dequeued, transferred);
+    return transferred;
+}
+
+// oldest element not yet overwritten, or NULL when empty
+static const struct lossy_element *head(const struct lossy_fifo_buffer *const self)
+{
+    const size_t read_index = atomic_load_explicit(&self->read_index, memory_order_acquire);
+    const size_t write_index = atomic_load_explicit(&self->write_index, memory_order_acquire);
+    if (read_index == write_index) {
+        return NULL;
+    }
+
+    const size_t position = write_index - read_index > self->capacity ? write_index - self->capacity : read_index;
+    return lossy_fifo_buffer_element_at(self, position);
+}
+
+const void *lossy_fifo_buffer_peek(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct lossy_element *const element = head((const struct lossy_fifo_buffer *)self);
+    return element != NULL ? element->buffer : NULL;
+}
+
+size_t lossy_fifo_buffer_peek_size(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct lossy_element *const element = head((const struct lossy_fifo_buffer *)self);
+    return element != NULL ? atomic_load_explicit(&element->size, memory_order_relaxed) : 0;
+}
+
+bool lossy_fifo_buffer_is_empty(const struct fifo_buffer *const self)
+{
+    return lossy_fifo_buffer_count(self) == 0;
+}
+
+bool lossy_fifo_buffer_is_full(const struct fifo_buffer *const self)
+{
+    return lossy_fifo_buffer_count(self) == lossy_fifo_buffer_capacity(self);
+}
+
+bool lossy_fifo_buffer_stats_snapshot(const struct fifo_buffer *const self, struct fifo_buffer_stats *const stats)
+{
+    assert(self != NULL);
+    assert(stats != NULL);
+
+#if defined(FIFO_BUFFER_STATS)
+    const struct lossy_fifo_buffer *const _self = (const struct lossy_fifo_buffer *)self;
+    fifo_buffer_stats_collect(&_self->producer_stats, &_self->consumer_stats, stats);
+    stats->overwritten = lossy_fifo_buffer_overwritten(self);
+    return true;
+#else
+    (void)self;
+    (void)stats;
+    return false;
+#endif
+}
@@ -0,0 +1,64 @@
+#ifndef LOSSY_FIFO_BUFFER_INTERNAL_H
+#define LOSSY_FIFO_BUFFER_INTERNAL_H
+
+#include <stddef.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#include "fifo_buffer.h"
+#include "fifo_buffer_stats_internal.h"
+#include "lockfree_fifo_buffer_internal.h"
+#include "lossy_fifo_buffer.h"
+
+// Slot of a lossy ring. While writing position p the producer holds sequence at
+// 2p + 1 and publishes 2p + 2 when done, so a reader that sees the same even value
+// before and after copying got an intact element, and knows which position it was.
+struct lossy_element {
+    atomic_size_t sequence;
+    atomic_size_t size;
+    alignas(max_align_t) uint8_t buffer[];
+};
+
+struct lossy_fifo_buffer {
+    struct fifo_buffer parent;
+    size_t element_size;
+    size_t capacity;
+    size_t element_stride;
+    uint8_t *buffer;
+
+    // producer side
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t write_index;
+#if defined(FIFO_BUFFER_STATS)
+    struct fifo_buffer_producer_stats producer_stats;
+#endif
+
+    // consumer side
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t read_index;
+    atomic_uint_fast64_t overwritten;
+#if defined(FIFO_BUFFER_STATS)
+    struct fifo_buffer_consumer_stats consumer_stats;
+#endif
+};
+
+static inline struct lossy_element *lossy_fifo_buffer_element_at(const struct lossy_fifo_buffer *const self, const size_t index)
+{
+    return (struct lossy_element *)(self->buffer + (index & (self->capacity - 1)) * self->element_stride);
+}
+
+size_t lossy_fifo_buffer_capacity(const struct fifo_buffer *self);
+size_t lossy_fifo_buffer_count(const struct fifo_buffer *self);
+bool lossy_fifo_buffer_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool lossy_fifo_buffer_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+bool lossy_fifo_buffer_dequeue_default(struct fifo_buffer *self, void *element);
+bool lossy_fifo_buffer_dequeue(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
+size_t lossy_fifo_buffer_enqueue_bulk(struct fifo_buffer *self, const void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+size_t lossy_fifo_buffer_dequeue_bulk(struct fifo_buffer *self, void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+const void *lossy_fifo_buffer_peek(const struct fifo_buffer *self);
+size_t lossy_fifo_buffer_peek_size(const struct fifo_buffer *self);
+bool lossy_fifo_buffer_is_empty(const struct fifo_buffer *self);
+bool lossy_fifo_buffer_is_full(const struct fifo_buffer *self);
+bool lossy_fifo_buffer_stats_snapshot(const struct fifo_buffer *self, struct fifo_buffer_stats *stats);
+
+#endif // LOSSY_FIFO_BUFFER_INTERNAL_H
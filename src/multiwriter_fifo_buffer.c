@@ -1,24 +1,35 @@
 #include <assert.h>
+#include <stdalign.h>
 #include <stdint.h>
 
+#include "combining_fifo_buffer_internal.h"
 #include "multiwriter_fifo_buffer.h"
 #include "multiwriter_fifo_buffer_internal.h"
+#include "sequenced_fifo_buffer_internal.h"
+
+static void mutex_dispose(struct fifo_buffer *self);
+static void mutex_delete(struct fifo_buffer *self);
+static bool mutex_try_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+static bool mutex_try_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
 
 static const union multiwriter_fifo_buffer_interface vtable = {
-    .dispose = multiwriter_fifo_buffer_dispose,
-    .free = multiwriter_fifo_buffer_delete,
+    .dispose = mutex_dispose,
+    .free = mutex_delete,
     .capacity = lockfree_fifo_buffer_capacity,
     .count = lockfree_fifo_buffer_count,
     .enqueue_default = multiwriter_fifo_buffer_enqueue_default,
     .enqueue = multiwriter_fifo_buffer_enqueue,
     .dequeue_default = lockfree_fifo_buffer_dequeue_default,
     .dequeue = lockfree_fifo_buffer_dequeue,
+    .enqueue_bulk = multiwriter_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = lockfree_fifo_buffer_dequeue_bulk,
     .peek = lockfree_fifo_buffer_peek,
     .peek_size = lockfree_fifo_buffer_peek_size,
     .is_empty = lockfree_fifo_buffer_is_empty,
     .is_full = lockfree_fifo_buffer_is_full,
-    .try_enqueue_default = multiwriter_fifo_buffer_try_enqueue_default,
-    .try_enqueue = multiwriter_fifo_buffer_try_enqueue,
+    .stats_snapshot = multiwriter_fifo_buffer_stats_snapshot,
+    .try_enqueue_default = mutex_try_enqueue_default,
+    .try_enqueue = mutex_try_enqueue,
 };
 
 bool multiwriter_fifo_buffer_initialize(struct multiwriter_fifo_buffer *const self, const size_t element_size, const size_t count)
@@ -36,13 +47,20 @@ bool multiwriter_fifo_buffer_initialize(struct multiwriter_fifo_buffer *const se
     }
 
     _self->parent.vptr = &vtable;
+#if defined(FIFO_BUFFER_STATS)
+    atomic_init(&_self->trylock_failures, 0);
+#endif
 
     return true;
 }
 
 struct multiwriter_fifo_buffer *multiwriter_fifo_buffer_new(const size_t element_size, const size_t count)
 {
-    struct multiwriter_fifo_buffer *const buf = (struct multiwriter_fifo_buffer *)malloc(sizeof(struct multiwriter_fifo_buffer_impl));
+    struct multiwriter_fifo_buffer *const buf = (struct multiwriter_fifo_buffer *)aligned_alloc(alignof(struct multiwriter_fifo_buffer_impl), sizeof(struct multiwriter_fifo_buffer_impl));
+    if (buf == NULL) {
+        return NULL;
+    }
+
     if (!multiwriter_fifo_buffer_initialize(buf, element_size, count)) {
         free(buf);
         return NULL;
@@ -51,23 +69,69 @@ struct multiwriter_fifo_buffer *multiwriter_fifo_buffer_new(const size_t element
     return buf;
 }
 
+struct multiwriter_fifo_buffer *multiwriter_fifo_buffer_new_with_strategy(const size_t element_size, const size_t count, const enum multiwriter_fifo_buffer_strategy strategy)
+{
+    switch (strategy) {
+    case MULTIWRITER_FIFO_BUFFER_MUTEX:
+        return multiwriter_fifo_buffer_new(element_size, count);
+    case MULTIWRITER_FIFO_BUFFER_LOCKFREE:
+        return sequenced_fifo_buffer_new(element_size, count);
+    case MULTIWRITER_FIFO_BUFFER_COMBINING:
+        return combining_fifo_buffer_new(element_size, count);
+    }
+
+    return NULL;
+}
+
+// The public entry points below work for every strategy, so they go through the vtable.
+
 void multiwriter_fifo_buffer_dispose(struct fifo_buffer *const self)
 {
     assert(self != NULL);
 
+    self->vptr->dispose(self);
+}
+
+void multiwriter_fifo_buffer_delete(struct fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    self->vptr->free(self);
+}
+
+bool multiwriter_fifo_buffer_try_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    assert(self != NULL);
+
+    return ((struct multiwriter_fifo_buffer *)self)->vptr->try_enqueue_default(self, element, size);
+}
+
+bool multiwriter_fifo_buffer_try_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    return ((struct multiwriter_fifo_buffer *)self)->vptr->try_enqueue(self, element, size, copy);
+}
+
+static void mutex_dispose(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
     struct multiwriter_fifo_buffer_impl *const _self = (struct multiwriter_fifo_buffer_impl *)self;
     pthread_mutex_destroy(&_self->mutex);
 
     lockfree_fifo_buffer_dispose(self);
 }
 
-void multiwriter_fifo_buffer_delete(struct fifo_buffer *const self)
+static void mutex_delete(struct fifo_buffer *const self)
 {
     if (self == NULL) {
         return;
     }
 
-    multiwriter_fifo_buffer_dispose(self);
+    mutex_dispose(self);
     free(self);
 }
 
@@ -95,12 +159,25 @@ bool multiwriter_fifo_buffer_enqueue(struct fifo_buffer *const self, const void
     return result;
 }
 
-bool multiwriter_fifo_buffer_try_enqueue_default(struct fifo_buffer *self, const void *element, size_t size)
+size_t multiwriter_fifo_buffer_enqueue_bulk(struct fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct multiwriter_fifo_buffer_impl *const _self = (struct multiwriter_fifo_buffer_impl *)self;
+    pthread_mutex_lock(&_self->mutex);
+    const size_t result = lockfree_fifo_buffer_enqueue_bulk(self, elements, size, count, copy);
+    pthread_mutex_unlock(&_self->mutex);
+
+    return result;
+}
+
+static bool mutex_try_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
 {
     assert(self != NULL);
 
     struct multiwriter_fifo_buffer_impl *const _self = (struct multiwriter_fifo_buffer_impl *)self;
     if (pthread_mutex_trylock(&_self->mutex) != 0) {
+        FIFO_BUFFER_STATS_ADD_SHARED(_self->trylock_failures, 1);
         return false;
     }
     const bool result = lockfree_fifo_buffer_enqueue_default(self, element, size);
@@ -109,12 +186,13 @@ bool multiwriter_fifo_buffer_try_enqueue_default(struct fifo_buffer *self, const
     return result;
 }
 
-bool multiwriter_fifo_buffer_try_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t))
+static bool mutex_try_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
 {
     assert(self != NULL);
 
     struct multiwriter_fifo_buffer_impl *const _self = (struct multiwriter_fifo_buffer_impl *)self;
     if (pthread_mutex_trylock(&_self->mutex) != 0) {
+        FIFO_BUFFER_STATS_ADD_SHARED(_self->trylock_failures, 1);
         return false;
     }
     const bool result = lockfree_fifo_buffer_enqueue(self, element, size, copy);
@@ -122,3 +200,15 @@ bool multiwriter_fifo_buffer_try_enqueue(struct fifo_buffer *self, const void *e
 
     return result;
 }
+
+bool multiwriter_fifo_buffer_stats_snapshot(const struct fifo_buffer *const self, struct fifo_buffer_stats *const stats)
+{
+    if (!lockfree_fifo_buffer_stats_snapshot(self, stats)) {
+        return false;
+    }
+
+#if defined(FIFO_BUFFER_STATS)
+    stats->trylock_failures = atomic_load_explicit(&((const struct multiwriter_fifo_buffer_impl *)self)->trylock_failures, memory_order_relaxed);
+#endif
+    return true;
+}
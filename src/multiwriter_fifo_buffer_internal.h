@@ -15,15 +15,21 @@ struct multiwriter_fifo_buffer_impl {
         struct lockfree_fifo_buffer super;
     };
     pthread_mutex_t mutex;
+#if defined(FIFO_BUFFER_STATS)
+    // bumped by any number of producers at once, so it gets its own line
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_uint_fast64_t trylock_failures;
+#endif
 };
 
 bool multiwriter_fifo_buffer_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
 bool multiwriter_fifo_buffer_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+size_t multiwriter_fifo_buffer_enqueue_bulk(struct fifo_buffer *self, const void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
 bool multiwriter_fifo_buffer_dequeue_default(struct fifo_buffer *self, void *element);
 bool multiwriter_fifo_buffer_dequeue(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
 const struct fifo_buffer_element *multiwriter_fifo_buffer_peek(const struct fifo_buffer *self);
 bool multiwriter_fifo_buffer_is_empty(const struct fifo_buffer *self);
 bool multiwriter_fifo_buffer_is_full(const struct fifo_buffer *self);
+bool multiwriter_fifo_buffer_stats_snapshot(const struct fifo_buffer *self, struct fifo_buffer_stats *stats);
 size_t multiwriter_fifo_buffer_next_index(const struct fifo_buffer *self, size_t index);
 
 #endif // MULTIWRITER_FIFO_BUFFER_INTERNAL_H
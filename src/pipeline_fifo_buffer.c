@@ -0,0 +1,244 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipeline_fifo_buffer.h"
+#include "pipeline_fifo_buffer_internal.h"
+
+static inline size_t calc_capacity(const size_t count)
+{
+    size_t capacity = 1;
+    while (capacity < count) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static inline size_t round_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+struct pipeline_fifo_buffer *pipeline_fifo_buffer_new(const size_t element_size, const size_t count, const size_t stages)
+{
+    if (stages == 0 || count > (SIZE_MAX >> 1) || stages >= SIZE_MAX / sizeof(struct pipeline_fifo_buffer_cursor)) {
+        return NULL;
+    }
+
+    const size_t capacity = calc_capacity(count);
+    const size_t element_stride = round_up(sizeof(struct lockfree_fifo_buffer_element) + element_size, alignof(struct lockfree_fifo_buffer_element));
+    if (capacity > (SIZE_MAX - LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) / element_stride) {
+        return NULL;
+    }
+
+    struct pipeline_fifo_buffer *const self = aligned_alloc(alignof(struct pipeline_fifo_buffer), sizeof(struct pipeline_fifo_buffer));
+    uint8_t *const buffer = (uint8_t *)aligned_alloc(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE, round_up(capacity * element_stride, LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE));
+    // sizeof is a multiple of the cache line because index is aligned to it
+    struct pipeline_fifo_buffer_cursor *const cursors = aligned_alloc(alignof(struct pipeline_fifo_buffer_cursor), (stages + 1) * sizeof(struct pipeline_fifo_buffer_cursor));
+    if (self == NULL || buffer == NULL || cursors == NULL) {
+        free(self);
+        free(buffer);
+        free(cursors);
+        return NULL;
+    }
+
+    *self = (struct pipeline_fifo_buffer){
+        .element_size = element_size,
+        .capacity = capacity,
+        .element_stride = element_stride,
+        .buffer = buffer,
+        .stages = stages,
+        .cursors = cursors,
+    };
+    for (size_t i = 0; i <= stages; i++) {
+        cursors[i] = (struct pipeline_fifo_buffer_cursor){ .cached_upstream_index = 0 };
+        atomic_init(&cursors[i].index, 0);
+    }
+
+    return self;
+}
+
+void pipeline_fifo_buffer_delete(struct pipeline_fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    free(self->cursors);
+    free(self->buffer);
+    free(self);
+}
+
+size_t pipeline_fifo_buffer_capacity(const struct pipeline_fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return self->capacity;
+}
+
+size_t pipeline_fifo_buffer_stages(const struct pipeline_fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return self->stages;
+}
+
+bool pipeline_fifo_buffer_enqueue_default(struct pipeline_fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return pipeline_fifo_buffer_enqueue(self, element, size, memcpy);
+}
+
+bool pipeline_fifo_buffer_enqueue(struct pipeline_fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    assert(size <= self->element_size);
+
+    void *const dest = pipeline_fifo_buffer_reserve(self);
+    if (dest == NULL) {
+        return false;
+    }
+
+    copy(dest, element, size);
+    pipeline_fifo_buffer_commit(self, size);
+    return true;
+}
+
+void *pipeline_fifo_buffer_reserve(struct pipeline_fifo_buffer *const self)
+{
+    void *element = NULL;
+    if (pipeline_fifo_buffer_reserve_n(self, &element, 1) == 0) {
+        return NULL;
+    }
+
+    return element;
+}
+
+void pipeline_fifo_buffer_commit(struct pipeline_fifo_buffer *const self, const size_t size)
+{
+    pipeline_fifo_buffer_commit_n(self, &size, 1);
+}
+
+size_t pipeline_fifo_buffer_reserve_n(struct pipeline_fifo_buffer *const self, void **const elements, const size_t count)
+{
+    assert(self != NULL);
+    assert(elements != NULL);
+
+    struct pipeline_fifo_buffer_cursor *const producer = &self->cursors[0];
+    const size_t current_index = atomic_load_explicit(&producer->index, memory_order_relaxed);
+
+    // the producer trails the last stage by one lap
+    size_t available = self->capacity - (current_index - producer->cached_upstream_index);
+    if (available < count) {
+        producer->cached_upstream_index = atomic_load_explicit(&self->cursors[self->stages].index, memory_order_acquire);
+        available = self->capacity - (current_index - producer->cached_upstream_index);
+    }
+
+    const size_t reserved = available < count ? available : count;
+    if (reserved == 0 && count > 0) {
+        FIFO_BUFFER_STATS_ADD(self->producer_stats.full_rejects, 1);
+    }
+    for (size_t i = 0; i < reserved; i++) {
+        elements[i] = pipeline_fifo_buffer_element_at(self, current_index + i)->buffer;
+    }
+
+    return reserved;
+}
+
+void pipeline_fifo_buffer_commit_n(struct pipeline_fifo_buffer *const self, const size_t *const sizes, const size_t count)
+{
+    assert(self != NULL);
+    assert(sizes != NULL || count == 0);
+
+    struct pipeline_fifo_buffer_cursor *const producer = &self->cursors[0];
+    const size_t current_index = atomic_load_explicit(&producer->index, memory_order_relaxed);
+    assert(self->capacity - (current_index - producer->cached_upstream_index) >= count);
+
+    for (size_t i = 0; i < count; i++) {
+        assert(sizes[i] <= self->element_size);
+        pipeline_fifo_buffer_element_at(self, current_index + i)->size = sizes[i];
+    }
+    atomic_store_explicit(&producer->index, current_index + count, memory_order_release);
+    for (size_t i = 0; i < count; i++) {
+        FIFO_BUFFER_STATS_RECORD_ENQUEUE(self->producer_stats, sizes[i], 1);
+    }
+}
+
+size_t pipeline_fifo_buffer_acquire_n(struct pipeline_fifo_buffer *const self, const size_t stage, void **const elements, size_t *const sizes, const size_t count)
+{
+    assert(self != NULL);
+    assert(stage < self->stages);
+    assert(elements != NULL);
+
+    struct pipeline_fifo_buffer_cursor *const cursor = &self->cursors[stage + 1];
+    const size_t current_index = atomic_load_explicit(&cursor->index, memory_order_relaxed);
+
+    size_t available = cursor->cached_upstream_index - current_index;
+    if (available < count) {
+        cursor->cached_upstream_index = atomic_load_explicit(&self->cursors[stage].index, memory_order_acquire);
+        available = cursor->cached_upstream_index - current_index;
+        FIFO_BUFFER_STATS_RECORD_OCCUPANCY(cursor->consumer_stats.high_water_mark, available);
+    }
+
+    const size_t acquired = available < count ? available : count;
+    if (acquired == 0 && count > 0) {
+        FIFO_BUFFER_STATS_ADD(cursor->consumer_stats.empty_polls, 1);
+    }
+    for (size_t i = 0; i < acquired; i++) {
+        struct lockfree_fifo_buffer_element *const element = pipeline_fifo_buffer_element_at(self, current_index + i);
+        elements[i] = element->buffer;
+        if (sizes != NULL) {
+            sizes[i] = element->size;
+        }
+    }
+
+    return acquired;
+}
+
+void pipeline_fifo_buffer_release(struct pipeline_fifo_buffer *const self, const size_t stage, const size_t *const sizes, const size_t count)
+{
+    assert(self != NULL);
+    assert(stage < self->stages);
+
+    struct pipeline_fifo_buffer_cursor *const cursor = &self->cursors[stage + 1];
+    const size_t current_index = atomic_load_explicit(&cursor->index, memory_order_relaxed);
+    assert(cursor->cached_upstream_index - current_index >= count);
+
+    if (sizes != NULL) {
+        for (size_t i = 0; i < count; i++) {
+            assert(sizes[i] <= self->element_size);
+            pipeline_fifo_buffer_element_at(self, current_index + i)->size = sizes[i];
+        }
+    }
+    atomic_store_explicit(&cursor->index, current_index + count, memory_order_release);
+    FIFO_BUFFER_STATS_ADD(cursor->consumer_stats.dequeued, count);
+}
+
+size_t pipeline_fifo_buffer_count(const struct pipeline_fifo_buffer *const self, const size_t stage)
+{
+    assert(self != NULL);
+    assert(stage < self->stages);
+
+    const size_t index = atomic_load_explicit(&self->cursors[stage + 1].index, memory_order_acquire);
+    const size_t upstream_index = atomic_load_explicit(&self->cursors[stage].index, memory_order_acquire);
+    return upstream_index - index;
+}
+
+bool pipeline_fifo_buffer_stats_snapshot(const struct pipeline_fifo_buffer *const self, const size_t stage, struct fifo_buffer_stats *const stats)
+{
+    assert(self != NULL);
+    assert(stage < self->stages);
+    assert(stats != NULL);
+
+#if defined(FIFO_BUFFER_STATS)
+    const struct pipeline_fifo_buffer_cursor *const cursor = &self->cursors[stage + 1];
+    fifo_buffer_stats_collect(&self->producer_stats, &cursor->consumer_stats, stats);
+    return true;
+#else
+    (void)self;
+    (void)stage;
+    (void)stats;
+    return false;
+#endif
+}
@@ -0,0 +1,42 @@
+#ifndef PIPELINE_FIFO_BUFFER_INTERNAL_H
+#define PIPELINE_FIFO_BUFFER_INTERNAL_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fifo_buffer_stats_internal.h"
+#include "lockfree_fifo_buffer_internal.h"
+#include "pipeline_fifo_buffer.h"
+
+// Free-running position of the producer (cursors[0]) or of a stage (cursors[s + 1]),
+// each on its own cache line together with what its owner last saw of the cursor it
+// trails: the previous one, or the last stage's for the producer.
+struct pipeline_fifo_buffer_cursor {
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t index;
+    size_t cached_upstream_index;
+#if defined(FIFO_BUFFER_STATS)
+    struct fifo_buffer_consumer_stats consumer_stats;
+#endif
+};
+
+struct pipeline_fifo_buffer {
+    size_t element_size;
+    size_t capacity;
+    size_t element_stride;
+    uint8_t *buffer;
+    size_t stages;
+    // stages + 1 of them
+    struct pipeline_fifo_buffer_cursor *cursors;
+#if defined(FIFO_BUFFER_STATS)
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) struct fifo_buffer_producer_stats producer_stats;
+#endif
+};
+
+static inline struct lockfree_fifo_buffer_element *pipeline_fifo_buffer_element_at(const struct pipeline_fifo_buffer *const self, const size_t index)
+{
+    return (struct lockfree_fifo_buffer_element *)(self->buffer + (index & (self->capacity - 1)) * self->element_stride);
+}
+
+#endif // PIPELINE_FIFO_BUFFER_INTERNAL_H
@@ -0,0 +1,337 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "multiwriter_fifo_buffer.h"
+#include "fifo_buffer_stats_internal.h"
+#include "sequenced_fifo_buffer_internal.h"
+
+static const union multiwriter_fifo_buffer_interface vtable = {
+    .dispose = sequenced_fifo_buffer_dispose,
+    .free = sequenced_fifo_buffer_delete,
+    .capacity = sequenced_fifo_buffer_capacity,
+    .count = sequenced_fifo_buffer_count,
+    .enqueue_default = sequenced_fifo_buffer_enqueue_default,
+    .enqueue = sequenced_fifo_buffer_enqueue,
+    .dequeue_default = sequenced_fifo_buffer_dequeue_default,
+    .dequeue = sequenced_fifo_buffer_dequeue,
+    .enqueue_bulk = sequenced_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = sequenced_fifo_buffer_dequeue_bulk,
+    .peek = sequenced_fifo_buffer_peek,
+    .peek_size = sequenced_fifo_buffer_peek_size,
+    .is_empty = sequenced_fifo_buffer_is_empty,
+    .is_full = sequenced_fifo_buffer_is_full,
+    .stats_snapshot = fifo_buffer_stats_unavailable,
+    .try_enqueue_default = sequenced_fifo_buffer_try_enqueue_default,
+    .try_enqueue = sequenced_fifo_buffer_try_enqueue,
+};
+
+static inline size_t calc_capacity(const size_t count)
+{
+    // a sequence ring needs at least two slots to tell a published slot from a free one
+    size_t capacity = 2;
+    while (capacity < count) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static inline size_t round_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool sequenced_fifo_buffer_initialize(struct sequenced_fifo_buffer *const self, const size_t element_size, const size_t count)
+{
+    assert(self != NULL);
+
+    if (count > (SIZE_MAX >> 1)) {
+        return false;
+    }
+
+    const size_t capacity = calc_capacity(count);
+    const size_t element_stride = round_up(sizeof(struct sequenced_element) + element_size, alignof(struct sequenced_element));
+    if (capacity > (SIZE_MAX - LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) / element_stride) {
+        return false;
+    }
+
+    uint8_t *const buffer = (uint8_t *)aligned_alloc(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE, round_up(capacity * element_stride, LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE));
+    if (buffer == NULL) {
+        return false;
+    }
+
+    self->multiwriter.vptr = &vtable;
+    self->element_size = element_size;
+    self->capacity = capacity;
+    self->element_stride = element_stride;
+    self->buffer = buffer;
+    atomic_init(&self->write_index, 0);
+    atomic_init(&self->read_index, 0);
+
+    for (size_t i = 0; i < capacity; i++) {
+        struct sequenced_element *const element = sequenced_fifo_buffer_element_at(self, i);
+        atomic_init(&element->sequence, i);
+        element->size = 0;
+    }
+
+    return true;
+}
+
+struct multiwriter_fifo_buffer *sequenced_fifo_buffer_new(const size_t element_size, const size_t count)
+{
+    struct sequenced_fifo_buffer *const buf = aligned_alloc(alignof(struct sequenced_fifo_buffer), sizeof(struct sequenced_fifo_buffer));
+    if (buf == NULL) {
+        return NULL;
+    }
+
+    if (!sequenced_fifo_buffer_initialize(buf, element_size, count)) {
+        free(buf);
+        return NULL;
+    }
+
+    return &buf->multiwriter;
+}
+
+void sequenced_fifo_buffer_dispose(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    struct sequenced_fifo_buffer *const _self = (struct sequenced_fifo_buffer *)self;
+
+    free(_self->buffer);
+    _self->parent.vptr = NULL;
+    _self->capacity = 0;
+    _self->element_size = 0;
+    _self->element_stride = 0;
+    _self->buffer = NULL;
+}
+
+void sequenced_fifo_buffer_delete(struct fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    sequenced_fifo_buffer_dispose(self);
+    free(self);
+}
+
+size_t sequenced_fifo_buffer_capacity(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return ((const struct sequenced_fifo_buffer *)self)->capacity;
+}
+
+size_t sequenced_fifo_buffer_count(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct sequenced_fifo_buffer *const _self = (const struct sequenced_fifo_buffer *)self;
+    const size_t read_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
+    const size_t write_index = atomic_load_explicit(&_self->write_index, memory_order_acquire);
+    const size_t count = write_index - read_index;
+    return count < _self->capacity ? count : _self->capacity;
+}
+
+bool sequenced_fifo_buffer_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return sequenced_fifo_buffer_enqueue(self, element, size, memcpy);
+}
+
+static inline void publish(struct sequenced_element *const dest, const size_t index, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    copy(dest->buffer, element, size);
+    dest->size = size;
+    atomic_store_explicit(&dest->sequence, index + 1, memory_order_release);
+}
+
+bool sequenced_fifo_buffer_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct sequenced_fifo_buffer *const _self = (struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+    for (;;) {
+        struct sequenced_element *const dest = sequenced_fifo_buffer_element_at(_self, current_index);
+        const size_t sequence = atomic_load_explicit(&dest->sequence, memory_order_acquire);
+        const intptr_t distance = (intptr_t)(sequence - current_index);
+
+        if (distance == 0) {
+            if (atomic_compare_exchange_weak_explicit(&_self->write_index, &current_index, current_index + 1, memory_order_relaxed, memory_order_relaxed)) {
+                publish(dest, current_index, element, size, copy);
+                return true;
+            }
+        } else if (distance < 0) {
+            return false;
+        } else {
+            current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+        }
+    }
+}
+
+bool sequenced_fifo_buffer_try_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return sequenced_fifo_buffer_try_enqueue(self, element, size, memcpy);
+}
+
+bool sequenced_fifo_buffer_try_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct sequenced_fifo_buffer *const _self = (struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    // a single claim attempt: fails when the ring is full or another producer won the slot
+    size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+    struct sequenced_element *const dest = sequenced_fifo_buffer_element_at(_self, current_index);
+    if (atomic_load_explicit(&dest->sequence, memory_order_acquire) != current_index) {
+        return false;
+    }
+    if (!atomic_compare_exchange_strong_explicit(&_self->write_index, &current_index, current_index + 1, memory_order_relaxed, memory_order_relaxed)) {
+        return false;
+    }
+
+    publish(dest, current_index, element, size, copy);
+    return true;
+}
+
+size_t sequenced_fifo_buffer_enqueue_bulk(struct fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct sequenced_fifo_buffer *const _self = (struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    if (count == 0) {
+        return 0;
+    }
+
+    size_t current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+    size_t transferred;
+    for (;;) {
+        // a slot is free for this lap once its sequence equals its position
+        size_t sequence = current_index;
+        for (transferred = 0; transferred < count && transferred < _self->capacity; transferred++) {
+            const size_t index = current_index + transferred;
+            sequence = atomic_load_explicit(&sequenced_fifo_buffer_element_at(_self, index)->sequence, memory_order_acquire);
+            if (sequence != index) {
+                break;
+            }
+        }
+
+        if (transferred > 0) {
+            if (atomic_compare_exchange_weak_explicit(&_self->write_index, &current_index, current_index + transferred, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if ((intptr_t)(sequence - current_index) < 0) {
+            return 0;
+        } else {
+            current_index = atomic_load_explicit(&_self->write_index, memory_order_relaxed);
+        }
+    }
+
+    const uint8_t *const src = (const uint8_t *)elements;
+    for (size_t i = 0; i < transferred; i++) {
+        publish(sequenced_fifo_buffer_element_at(_self, current_index + i), current_index + i, src + i * size, size, copy);
+    }
+    return transferred;
+}
+
+bool sequenced_fifo_buffer_dequeue_default(struct fifo_buffer *const self, void *const element)
+{
+    return sequenced_fifo_buffer_dequeue(self, element, memcpy);
+}
+
+bool sequenced_fifo_buffer_dequeue(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    return sequenced_fifo_buffer_dequeue_bulk(self, element, ((struct sequenced_fifo_buffer *)self)->element_size, 1, copy) == 1;
+}
+
+size_t sequenced_fifo_buffer_dequeue_bulk(struct fifo_buffer *const self, void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct sequenced_fifo_buffer *const _self = (struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+    uint8_t *const dest = (uint8_t *)elements;
+
+    size_t transferred = 0;
+    while (transferred < count) {
+        const size_t index = current_index + transferred;
+        struct sequenced_element *const src = sequenced_fifo_buffer_element_at(_self, index);
+        if (atomic_load_explicit(&src->sequence, memory_order_acquire) != index + 1) {
+            break;
+        }
+
+        if (dest != NULL && copy != NULL) {
+            copy(dest + transferred * size, src->buffer, src->size < size ? src->size : size);
+        }
+        atomic_store_explicit(&src->sequence, index + _self->capacity, memory_order_release);
+        transferred++;
+    }
+
+    if (transferred > 0) {
+        atomic_store_explicit(&_self->read_index, current_index + transferred, memory_order_release);
+    }
+    return transferred;
+}
+
+const void *sequenced_fifo_buffer_peek(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct sequenced_fifo_buffer *const _self = (const struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    if (sequenced_fifo_buffer_is_empty(self)) {
+        return NULL;
+    }
+
+    const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+    return sequenced_fifo_buffer_element_at(_self, current_index)->buffer;
+}
+
+size_t sequenced_fifo_buffer_peek_size(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct sequenced_fifo_buffer *const _self = (const struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    if (sequenced_fifo_buffer_is_empty(self)) {
+        return 0;
+    }
+
+    const size_t current_index = atomic_load_explicit(&_self->read_index, memory_order_relaxed);
+    return sequenced_fifo_buffer_element_at(_self, current_index)->size;
+}
+
+bool sequenced_fifo_buffer_is_empty(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct sequenced_fifo_buffer *const _self = (const struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    // empty until the head slot is published, even if a producer already claimed it
+    const size_t read_index = atomic_load_explicit(&_self->read_index, memory_order_acquire);
+    const struct sequenced_element *const head = sequenced_fifo_buffer_element_at(_self, read_index);
+    return atomic_load_explicit(&head->sequence, memory_order_acquire) != read_index + 1;
+}
+
+bool sequenced_fifo_buffer_is_full(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct sequenced_fifo_buffer *const _self = (const struct sequenced_fifo_buffer *)self;
+    assert(_self->buffer != NULL);
+
+    return sequenced_fifo_buffer_count(self) >= _self->capacity;
+}
@@ -0,0 +1,64 @@
+#ifndef SEQUENCED_FIFO_BUFFER_INTERNAL_H
+#define SEQUENCED_FIFO_BUFFER_INTERNAL_H
+
+#include <stddef.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#include "fifo_buffer.h"
+#include "lockfree_fifo_buffer_internal.h"
+#include "multiwriter_fifo_buffer.h"
+#include "concurrent_fifo_buffer.h"
+
+// Slot of a ring where producers claim positions by CAS on write_index and hand
+// the slot over to the consumer by publishing sequence = position + 1.
+// The consumer gives it back by publishing sequence = position + capacity.
+struct sequenced_element {
+    atomic_size_t sequence;
+    size_t size;
+    alignas(max_align_t) uint8_t buffer[];
+};
+
+struct sequenced_fifo_buffer {
+    union {
+        struct fifo_buffer parent;
+        struct multiwriter_fifo_buffer multiwriter;
+        struct concurrent_fifo_buffer concurrent;
+    };
+    size_t element_size;
+    size_t capacity;
+    size_t element_stride;
+    uint8_t *buffer;
+
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t write_index;
+
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t read_index;
+};
+
+static inline struct sequenced_element *sequenced_fifo_buffer_element_at(const struct sequenced_fifo_buffer *const self, const size_t index)
+{
+    return (struct sequenced_element *)(self->buffer + (index & (self->capacity - 1)) * self->element_stride);
+}
+
+bool sequenced_fifo_buffer_initialize(struct sequenced_fifo_buffer *self, size_t element_size, size_t count);
+struct multiwriter_fifo_buffer *sequenced_fifo_buffer_new(size_t element_size, size_t count);
+void sequenced_fifo_buffer_dispose(struct fifo_buffer *self);
+void sequenced_fifo_buffer_delete(struct fifo_buffer *self);
+size_t sequenced_fifo_buffer_capacity(const struct fifo_buffer *self);
+size_t sequenced_fifo_buffer_count(const struct fifo_buffer *self);
+bool sequenced_fifo_buffer_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool sequenced_fifo_buffer_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+bool sequenced_fifo_buffer_try_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool sequenced_fifo_buffer_try_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+size_t sequenced_fifo_buffer_enqueue_bulk(struct fifo_buffer *self, const void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+bool sequenced_fifo_buffer_dequeue_default(struct fifo_buffer *self, void *element);
+bool sequenced_fifo_buffer_dequeue(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
+size_t sequenced_fifo_buffer_dequeue_bulk(struct fifo_buffer *self, void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+const void *sequenced_fifo_buffer_peek(const struct fifo_buffer *self);
+size_t sequenced_fifo_buffer_peek_size(const struct fifo_buffer *self);
+bool sequenced_fifo_buffer_is_empty(const struct fifo_buffer *self);
+bool sequenced_fifo_buffer_is_full(const struct fifo_buffer *self);
+
+#endif // SEQUENCED_FIFO_BUFFER_INTERNAL_H
@@ -0,0 +1,338 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sharded_fifo_buffer.h"
+#include "sharded_fifo_buffer_internal.h"
+
+static const struct fifo_buffer_interface vtable = {
+    .dispose = sharded_fifo_buffer_dispose,
+    .free = sharded_fifo_buffer_delete,
+    .capacity = sharded_fifo_buffer_capacity,
+    .count = sharded_fifo_buffer_count,
+    .enqueue_default = sharded_fifo_buffer_enqueue_default,
+    .enqueue = sharded_fifo_buffer_enqueue,
+    .dequeue_default = sharded_fifo_buffer_dequeue_default,
+    .dequeue = sharded_fifo_buffer_dequeue,
+    .enqueue_bulk = sharded_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = sharded_fifo_buffer_dequeue_bulk,
+    .peek = sharded_fifo_buffer_peek,
+    .peek_size = sharded_fifo_buffer_peek_size,
+    .is_empty = sharded_fifo_buffer_is_empty,
+    .is_full = sharded_fifo_buffer_is_full,
+    .stats_snapshot = sharded_fifo_buffer_stats_snapshot,
+};
+
+struct sharded_fifo_buffer *sharded_fifo_buffer_new(const size_t element_size, const size_t count, const size_t max_producers)
+{
+    if (max_producers >= SIZE_MAX / sizeof(struct sharded_fifo_buffer_shard)) {
+        return NULL;
+    }
+
+    const size_t shard_count = max_producers + 1;
+    struct sharded_fifo_buffer *const self = malloc(sizeof(struct sharded_fifo_buffer));
+    struct sharded_fifo_buffer_shard *const shards = aligned_alloc(alignof(struct sharded_fifo_buffer_shard), shard_count * sizeof(struct sharded_fifo_buffer_shard));
+    if (self == NULL || shards == NULL || pthread_mutex_init(&self->shared_lock, NULL) != 0) {
+        free(shards);
+        free(self);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < shard_count; i++) {
+        if (!lockfree_fifo_buffer_initialize(&shards[i].ring, element_size, count)) {
+            while (i-- > 0) {
+                lockfree_fifo_buffer_dispose(&shards[i].ring.parent);
+            }
+            pthread_mutex_destroy(&self->shared_lock);
+            free(shards);
+            free(self);
+            return NULL;
+        }
+        atomic_init(&shards[i].state, i == 0 ? SHARDED_FIFO_BUFFER_SHARD_ACTIVE : SHARDED_FIFO_BUFFER_SHARD_FREE);
+        atomic_init(&shards[i].weight, 1);
+    }
+
+    self->parent.vptr = &vtable;
+    self->shard_count = shard_count;
+    self->shards = shards;
+    self->current = 0;
+    self->credit = 1;
+#if defined(FIFO_BUFFER_STATS)
+    atomic_init(&self->consumer_stats.dequeued, 0);
+    atomic_init(&self->consumer_stats.empty_polls, 0);
+    atomic_init(&self->consumer_stats.high_water_mark, 0);
+#endif
+    return self;
+}
+
+void sharded_fifo_buffer_dispose(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    struct sharded_fifo_buffer *const _self = (struct sharded_fifo_buffer *)self;
+
+    for (size_t i = 0; i < _self->shard_count; i++) {
+        lockfree_fifo_buffer_dispose(&_self->shards[i].ring.parent);
+    }
+    pthread_mutex_destroy(&_self->shared_lock);
+    free(_self->shards);
+    _self->parent.vptr = NULL;
+    _self->shard_count = 0;
+    _self->shards = NULL;
+}
+
+void sharded_fifo_buffer_delete(struct fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    sharded_fifo_buffer_dispose(self);
+    free(self);
+}
+
+struct fifo_buffer *sharded_fifo_buffer_register(struct fifo_buffer *const self)
+{
+    return sharded_fifo_buffer_register_weighted(self, 1);
+}
+
+struct fifo_buffer *sharded_fifo_buffer_register_weighted(struct fifo_buffer *const self, const unsigned weight)
+{
+    assert(self != NULL);
+    assert(weight > 0);
+    struct sharded_fifo_buffer *const _self = (struct sharded_fifo_buffer *)self;
+
+    for (size_t i = 1; i < _self->shard_count; i++) {
+        struct sharded_fifo_buffer_shard *const shard = &_self->shards[i];
+        unsigned expected = SHARDED_FIFO_BUFFER_SHARD_FREE;
+        if (atomic_compare_exchange_strong_explicit(&shard->state, &expected, SHARDED_FIFO_BUFFER_SHARD_CLAIMED, memory_order_acquire, memory_order_relaxed)) {
+            atomic_store_explicit(&shard->weight, weight, memory_order_relaxed);
+            atomic_store_explicit(&shard->state, SHARDED_FIFO_BUFFER_SHARD_ACTIVE, memory_order_release);
+            return &shard->ring.parent;
+        }
+    }
+    return NULL;
+}
+
+void sharded_fifo_buffer_unregister(struct fifo_buffer *const self, struct fifo_buffer *const producer)
+{
+    assert(self != NULL);
+    assert(producer != NULL);
+    struct sharded_fifo_buffer *const _self = (struct sharded_fifo_buffer *)self;
+    struct sharded_fifo_buffer_shard *const shard = (struct sharded_fifo_buffer_shard *)producer;
+    assert(shard > &_self->shards[0] && shard < &_self->shards[_self->shard_count]);
+    (void)_self;
+
+    // releases the last enqueues to the consumer, which frees the shard once it is empty
+    atomic_store_explicit(&shard->state, SHARDED_FIFO_BUFFER_SHARD_RETIRING, memory_order_release);
+}
+
+size_t sharded_fifo_buffer_capacity(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    const struct sharded_fifo_buffer *const _self = (const struct sharded_fifo_buffer *)self;
+    return _self->shard_count * lockfree_fifo_buffer_capacity(&_self->shards[0].ring.parent);
+}
+
+size_t sharded_fifo_buffer_count(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    const struct sharded_fifo_buffer *const _self = (const struct sharded_fifo_buffer *)self;
+
+    // free shards are drained, so they add nothing
+    size_t count = 0;
+    for (size_t i = 0; i < _self->shard_count; i++) {
+        count += lockfree_fifo_buffer_count(&_self->shards[i].ring.parent);
+    }
+    return count;
+}
+
+bool sharded_fifo_buffer_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return sharded_fifo_buffer_enqueue(self, element, size, memcpy);
+}
+
+bool sharded_fifo_buffer_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    struct sharded_fifo_buffer *const _self = (struct sharded_fifo_buffer *)self;
+
+    pthread_mutex_lock(&_self->shared_lock);
+    const bool enqueued = lockfree_fifo_buffer_enqueue(&_self->shards[0].ring.parent, element, size, copy);
+    pthread_mutex_unlock(&_self->shared_lock);
+    return enqueued;
+}
+
+size_t sharded_fifo_buffer_enqueue_bulk(struct fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    struct sharded_fifo_buffer *const _self = (struct sharded_fifo_buffer *)self;
+
+    pthread_mutex_lock(&_self->shared_lock);
+    const size_t enqueued = lockfree_fifo_buffer_enqueue_bulk(&_self->shards[0].ring.parent, elements, size, count, copy);
+    pthread_mutex_unlock(&_self->shared_lock);
+    return enqueued;
+}
+
+// First shard from current on with something queued, or NULL. Retiring shards found
+// empty are freed on the way when release is set.
+static struct sharded_fifo_buffer_shard *find_shard(const struct sharded_fifo_buffer *const self, size_t *const index, const bool release)
+{
+    for (size_t i = 0; i < self->shard_count; i++) {
+        const size_t candidate = (self->current + i) % self->shard_count;
+        struct sharded_fifo_buffer_shard *const shard = &self->shards[candidate];
+
+        const unsigned state = atomic_load_explicit(&shard->state, memory_order_acquire);
+        if (state != SHARDED_FIFO_BUFFER_SHARD_ACTIVE && state != SHARDED_FIFO_BUFFER_SHARD_RETIRING) {
+            continue;
+        }
+        if (!lockfree_fifo_buffer_is_empty(&shard->ring.parent)) {
+            *index = candidate;
+            return shard;
+        }
+        if (state == SHARDED_FIFO_BUFFER_SHARD_RETIRING && release) {
+            atomic_store_explicit(&shard->state, SHARDED_FIFO_BUFFER_SHARD_FREE, memory_order_release);
+        }
+    }
+    return NULL;
+}
+
+// Charges taken elements to the shard at index and moves on once its turn is over.
+static void consume(struct sharded_fifo_buffer *const self, const size_t index, const size_t taken)
+{
+    if (index != self->current) {
+        self->current = index;
+        self->credit = atomic_load_explicit(&self->shards[index].weight, memory_order_relaxed);
+    }
+
+    assert(taken <= self->credit);
+    self->credit -= (unsigned)taken;
+    if (self->credit == 0) {
+        self->current = (index + 1) % self->shard_count;
+        self->credit = atomic_load_explicit(&self->shards[self->current].weight, memory_order_relaxed);
+    }
+}
+
+// Elements the shard at index may give before the consumer moves on.
+static unsigned turn(const struct sharded_fifo_buffer *const self, const size_t index)
+{
+    return index == self->current ? self->credit : atomic_load_explicit(&self->shards[index].weight, memory_order_relaxed);
+}
+
+bool sharded_fifo_buffer_dequeue_default(struct fifo_buffer *const self, void *const element)
+{
+    return sharded_fifo_buffer_dequeue(self, element, memcpy);
+}
+
+bool sharded_fifo_buffer_dequeue(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    struct sharded_fifo_buffer *const _self = (struct sharded_fifo_buffer *)self;
+
+    size_t index = 0;
+    struct sharded_fifo_buffer_shard *const shard = find_shard(_self, &index, true);
+    if (shard == NULL) {
+        FIFO_BUFFER_STATS_ADD(_self->consumer_stats.empty_polls, 1);
+        return false;
+    }
+
+    // only this consumer dequeues, so a non-empty shard stays non-empty
+    const bool dequeued = lockfree_fifo_buffer_dequeue(&shard->ring.parent, element, copy);
+    assert(dequeued);
+    consume(_self, index, 1);
+    return dequeued;
+}
+
+size_t sharded_fifo_buffer_dequeue_bulk(struct fifo_buffer *const self, void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    struct sharded_fifo_buffer *const _self = (struct sharded_fifo_buffer *)self;
+
+    uint8_t *const dest = (uint8_t *)elements;
+    size_t transferred = 0;
+    while (transferred < count) {
+        size_t index = 0;
+        struct sharded_fifo_buffer_shard *const shard = find_shard(_self, &index, true);
+        if (shard == NULL) {
+            break;
+        }
+
+        const size_t remaining = count - transferred;
+        const size_t allowed = turn(_self, index);
+        const size_t taken = lockfree_fifo_buffer_dequeue_bulk(&shard->ring.parent, dest != NULL ? dest + transferred * size : NULL, size, remaining < allowed ? remaining : allowed, copy);
+        consume(_self, index, taken);
+        transferred += taken;
+    }
+
+    if (transferred == 0 && count > 0) {
+        FIFO_BUFFER_STATS_ADD(_self->consumer_stats.empty_polls, 1);
+    }
+    return transferred;
+}
+
+const void *sharded_fifo_buffer_peek(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    size_t index = 0;
+    const struct sharded_fifo_buffer_shard *const shard = find_shard((const struct sharded_fifo_buffer *)self, &index, false);
+    return shard != NULL ? lockfree_fifo_buffer_peek(&shard->ring.parent) : NULL;
+}
+
+size_t sharded_fifo_buffer_peek_size(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    size_t index = 0;
+    const struct sharded_fifo_buffer_shard *const shard = find_shard((const struct sharded_fifo_buffer *)self, &index, false);
+    return shard != NULL ? lockfree_fifo_buffer_peek_size(&shard->ring.parent) : 0;
+}
+
+bool sharded_fifo_buffer_is_empty(const struct fifo_buffer *const self)
+{
+    return sharded_fifo_buffer_count(self) == 0;
+}
+
+// whether enqueueing on the buffer itself would fail; handles have their own is_full
+bool sharded_fifo_buffer_is_full(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return lockfree_fifo_buffer_is_full(&((const struct sharded_fifo_buffer *)self)->shards[0].ring.parent);
+}
+
+bool sharded_fifo_buffer_stats_snapshot(const struct fifo_buffer *const self, struct fifo_buffer_stats *const stats)
+{
+    assert(self != NULL);
+    assert(stats != NULL);
+
+#if defined(FIFO_BUFFER_STATS)
+    const struct sharded_fifo_buffer *const _self = (const struct sharded_fifo_buffer *)self;
+
+    // sum of the shards, except that an empty poll is one of the whole buffer
+    *stats = (struct fifo_buffer_stats){ .page_backing = FIFO_BUFFER_PAGES_SMALL };
+    for (size_t i = 0; i < _self->shard_count; i++) {
+        struct fifo_buffer_stats shard_stats;
+        lockfree_fifo_buffer_stats_snapshot(&_self->shards[i].ring.parent, &shard_stats);
+
+        stats->enqueued += shard_stats.enqueued;
+        stats->dequeued += shard_stats.dequeued;
+        stats->full_rejects += shard_stats.full_rejects;
+        if (shard_stats.high_water_mark > stats->high_water_mark) {
+            stats->high_water_mark = shard_stats.high_water_mark;
+        }
+        for (size_t bucket = 0; bucket < FIFO_BUFFER_STATS_SIZE_BUCKETS; bucket++) {
+            stats->size_histogram[bucket] += shard_stats.size_histogram[bucket];
+        }
+    }
+    stats->empty_polls = atomic_load_explicit(&_self->consumer_stats.empty_polls, memory_order_relaxed);
+    return true;
+#else
+    (void)self;
+    (void)stats;
+    return false;
+#endif
+}
@@ -0,0 +1,58 @@
+#ifndef SHARDED_FIFO_BUFFER_INTERNAL_H
+#define SHARDED_FIFO_BUFFER_INTERNAL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "fifo_buffer.h"
+#include "fifo_buffer_stats_internal.h"
+#include "lockfree_fifo_buffer_internal.h"
+#include "sharded_fifo_buffer.h"
+
+enum sharded_fifo_buffer_shard_state {
+    SHARDED_FIFO_BUFFER_SHARD_FREE,
+    // taken by a registering producer, not visible to the consumer yet
+    SHARDED_FIFO_BUFFER_SHARD_CLAIMED,
+    SHARDED_FIFO_BUFFER_SHARD_ACTIVE,
+    // unregistered; the consumer frees it once drained
+    SHARDED_FIFO_BUFFER_SHARD_RETIRING,
+};
+
+struct sharded_fifo_buffer_shard {
+    // first, so that the producer handle converts back to its shard
+    struct lockfree_fifo_buffer ring;
+    atomic_uint state;
+    atomic_uint weight;
+};
+
+struct sharded_fifo_buffer {
+    struct fifo_buffer parent;
+    // max_producers + 1; shard 0 is shared by producers without a handle
+    size_t shard_count;
+    struct sharded_fifo_buffer_shard *shards;
+    pthread_mutex_t shared_lock;
+
+    // consumer side: shard being drained and elements it may still give this round
+    size_t current;
+    unsigned credit;
+#if defined(FIFO_BUFFER_STATS)
+    struct fifo_buffer_consumer_stats consumer_stats;
+#endif
+};
+
+size_t sharded_fifo_buffer_capacity(const struct fifo_buffer *self);
+size_t sharded_fifo_buffer_count(const struct fifo_buffer *self);
+bool sharded_fifo_buffer_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool sharded_fifo_buffer_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+bool sharded_fifo_buffer_dequeue_default(struct fifo_buffer *self, void *element);
+bool sharded_fifo_buffer_dequeue(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
+size_t sharded_fifo_buffer_enqueue_bulk(struct fifo_buffer *self, const void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+size_t sharded_fifo_buffer_dequeue_bulk(struct fifo_buffer *self, void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+const void *sharded_fifo_buffer_peek(const struct fifo_buffer *self);
+size_t sharded_fifo_buffer_peek_size(const struct fifo_buffer *self);
+bool sharded_fifo_buffer_is_empty(const struct fifo_buffer *self);
+bool sharded_fifo_buffer_is_full(const struct fifo_buffer *self);
+bool sharded_fifo_buffer_stats_snapshot(const struct fifo_buffer *self, struct fifo_buffer_stats *stats);
+
+#endif // SHARDED_FIFO_BUFFER_INTERNAL_H
@@ -0,0 +1,601 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "shm_fifo_buffer.h"
+#include "shm_fifo_buffer_internal.h"
+
+static const struct fifo_buffer_interface single_writer_vtable = {
+    .dispose = shm_fifo_buffer_dispose,
+    .free = shm_fifo_buffer_delete,
+    .capacity = shm_fifo_buffer_capacity,
+    .count = shm_fifo_buffer_count,
+    .enqueue_default = shm_fifo_buffer_enqueue_default,
+    .enqueue = shm_fifo_buffer_enqueue,
+    .dequeue_default = shm_fifo_buffer_dequeue_default,
+    .dequeue = shm_fifo_buffer_dequeue,
+    .enqueue_bulk = shm_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = shm_fifo_buffer_dequeue_bulk,
+    .peek = shm_fifo_buffer_peek,
+    .peek_size = shm_fifo_buffer_peek_size,
+    .is_empty = shm_fifo_buffer_is_empty,
+    .is_full = shm_fifo_buffer_is_full,
+    .stats_snapshot = fifo_buffer_stats_unavailable,
+};
+
+static const union multiwriter_fifo_buffer_interface multiwriter_vtable = {
+    .dispose = shm_fifo_buffer_dispose,
+    .free = shm_fifo_buffer_delete,
+    .capacity = shm_fifo_buffer_capacity,
+    .count = shm_fifo_buffer_count,
+    .enqueue_default = shm_fifo_buffer_enqueue_default,
+    .enqueue = shm_fifo_buffer_enqueue,
+    .dequeue_default = shm_fifo_buffer_dequeue_default,
+    .dequeue = shm_fifo_buffer_dequeue,
+    .enqueue_bulk = shm_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = shm_fifo_buffer_dequeue_bulk,
+    .peek = shm_fifo_buffer_peek,
+    .peek_size = shm_fifo_buffer_peek_size,
+    .is_empty = shm_fifo_buffer_is_empty,
+    .is_full = shm_fifo_buffer_is_full,
+    .stats_snapshot = fifo_buffer_stats_unavailable,
+    .try_enqueue_default = shm_fifo_buffer_try_enqueue_default,
+    .try_enqueue = shm_fifo_buffer_try_enqueue,
+};
+
+static inline size_t round_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// same sizing rule as lockfree_fifo_buffer: smallest power of two >= count, at least one slot
+static inline size_t calc_aligned_capacity(const size_t count)
+{
+    size_t capacity = 1;
+    while (capacity < count && capacity <= SIZE_MAX / 2) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static struct shm_fifo_buffer *map_region(const int fd, const size_t region_size)
+{
+    struct shm_fifo_buffer *const self = malloc(sizeof(struct shm_fifo_buffer));
+    if (self == NULL) {
+        return NULL;
+    }
+
+    void *const region = mmap(NULL, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        free(self);
+        return NULL;
+    }
+
+    *self = (struct shm_fifo_buffer){
+        .header = (struct shm_fifo_buffer_header *)region,
+        .region_size = region_size,
+        .fd = fd,
+    };
+    return self;
+}
+
+// Copies the geometry out of the header. Everything after this reads the local copy,
+// so attach() validates exactly what the ring will use.
+static size_t load_geometry(struct shm_fifo_buffer *const self)
+{
+    const struct shm_fifo_buffer_header *const header = self->header;
+    self->element_size = (size_t)header->element_size;
+    self->capacity = (size_t)header->capacity;
+    self->element_stride = (size_t)header->element_stride;
+    self->mode = (enum shm_fifo_buffer_mode)header->mode;
+    return (size_t)header->slots_offset;
+}
+
+static void bind_vtable(struct shm_fifo_buffer *const self, const size_t slots_offset)
+{
+    self->slots = (uint8_t *)self->header + slots_offset;
+    if (self->mode == SHM_FIFO_BUFFER_MULTIWRITER) {
+        self->multiwriter.vptr = &multiwriter_vtable;
+    } else {
+        self->parent.vptr = &single_writer_vtable;
+    }
+}
+
+static bool initialize_mutex(pthread_mutex_t *const mutex)
+{
+    pthread_mutexattr_t attributes;
+    if (pthread_mutexattr_init(&attributes) != 0) {
+        return false;
+    }
+
+    const bool result = pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED) == 0 &&
+                        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST) == 0 &&
+                        pthread_mutex_init(mutex, &attributes) == 0;
+    pthread_mutexattr_destroy(&attributes);
+    return result;
+}
+
+// Sizes fd for the ring, maps it and writes the header. Takes ownership of fd.
+static struct shm_fifo_buffer *format(const int fd, const size_t element_size, const size_t count, const enum shm_fifo_buffer_mode mode)
+{
+    const size_t capacity = calc_aligned_capacity(count);
+    const size_t element_stride = round_up(sizeof(struct lockfree_fifo_buffer_element) + element_size, alignof(struct lockfree_fifo_buffer_element));
+    const size_t slots_offset = round_up(sizeof(struct shm_fifo_buffer_header), LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE);
+    if (capacity > (SIZE_MAX - slots_offset) / element_stride) {
+        close(fd);
+        return NULL;
+    }
+
+    const size_t region_size = slots_offset + capacity * element_stride;
+    if (ftruncate(fd, (off_t)region_size) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    struct shm_fifo_buffer *const self = map_region(fd, region_size);
+    if (self == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    struct shm_fifo_buffer_header *const header = self->header;
+    *header = (struct shm_fifo_buffer_header){
+        .magic = SHM_FIFO_BUFFER_MAGIC,
+        .version = SHM_FIFO_BUFFER_VERSION,
+        .mode = (uint32_t)mode,
+        .element_size = element_size,
+        .capacity = capacity,
+        .element_stride = element_stride,
+        .slots_offset = slots_offset,
+        .region_size = region_size,
+    };
+    atomic_init(&header->write_index, 0);
+    atomic_init(&header->read_index, 0);
+
+    // indices have to work from any mapping, which only holds for lock-free atomics
+    if (!atomic_is_lock_free(&header->write_index) || !initialize_mutex(&header->mutex)) {
+        shm_fifo_buffer_delete(&self->parent);
+        return NULL;
+    }
+
+    bind_vtable(self, load_geometry(self));
+    atomic_store_explicit(&header->ready, SHM_FIFO_BUFFER_VERSION, memory_order_release);
+    return self;
+}
+
+struct shm_fifo_buffer *shm_fifo_buffer_create(const char *const name, const size_t element_size, const size_t count, const enum shm_fifo_buffer_mode mode)
+{
+    assert(name != NULL);
+
+    const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct shm_fifo_buffer *const self = format(fd, element_size, count, mode);
+    if (self == NULL) {
+        shm_unlink(name);
+    }
+    return self;
+}
+
+static int create_anonymous_fd(void)
+{
+#if defined(__linux__)
+    return memfd_create("lockfree_queue", MFD_CLOEXEC);
+#else
+    char name[64];
+    for (unsigned attempt = 0; attempt < 16; attempt++) {
+        snprintf(name, sizeof(name), "/lockfree_queue.%ld.%u.%d", (long)getpid(), attempt, rand());
+        const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            shm_unlink(name);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+            return fd;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+    return -1;
+#endif
+}
+
+struct shm_fifo_buffer *shm_fifo_buffer_create_anonymous(const size_t element_size, const size_t count, const enum shm_fifo_buffer_mode mode)
+{
+    const int fd = create_anonymous_fd();
+    if (fd < 0) {
+        return NULL;
+    }
+
+    return format(fd, element_size, count, mode);
+}
+
+// Maps a formatted region and checks its header. Takes ownership of fd.
+static struct shm_fifo_buffer *attach(const int fd)
+{
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (size_t)status.st_size < sizeof(struct shm_fifo_buffer_header)) {
+        close(fd);
+        return NULL;
+    }
+
+    const size_t region_size = (size_t)status.st_size;
+    struct shm_fifo_buffer *const self = map_region(fd, region_size);
+    if (self == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    const struct shm_fifo_buffer_header *const header = self->header;
+    const bool ready = atomic_load_explicit(&header->ready, memory_order_acquire) == SHM_FIFO_BUFFER_VERSION &&
+                       header->magic == SHM_FIFO_BUFFER_MAGIC &&
+                       header->version == SHM_FIFO_BUFFER_VERSION &&
+                       header->region_size == region_size;
+    const size_t slots_offset = load_geometry(self);
+    const bool valid = ready &&
+                       (self->mode == SHM_FIFO_BUFFER_SINGLE_WRITER || self->mode == SHM_FIFO_BUFFER_MULTIWRITER) &&
+                       self->capacity >= 1 && (self->capacity & (self->capacity - 1)) == 0 &&
+                       self->element_stride >= sizeof(struct lockfree_fifo_buffer_element) &&
+                       self->element_size <= self->element_stride - sizeof(struct lockfree_fifo_buffer_element) &&
+                       slots_offset >= sizeof(struct shm_fifo_buffer_header) && slots_offset <= region_size &&
+                       self->capacity <= (region_size - slots_offset) / self->element_stride;
+    if (!valid) {
+        shm_fifo_buffer_delete(&self->parent);
+        return NULL;
+    }
+
+    bind_vtable(self, slots_offset);
+    return self;
+}
+
+struct shm_fifo_buffer *shm_fifo_buffer_attach(const char *const name)
+{
+    assert(name != NULL);
+
+    const int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    return attach(fd);
+}
+
+struct shm_fifo_buffer *shm_fifo_buffer_attach_fd(const int fd)
+{
+    const int own_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (own_fd < 0) {
+        return NULL;
+    }
+
+    return attach(own_fd);
+}
+
+bool shm_fifo_buffer_unlink(const char *const name)
+{
+    assert(name != NULL);
+    return shm_unlink(name) == 0;
+}
+
+int shm_fifo_buffer_fd(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return ((const struct shm_fifo_buffer *)self)->fd;
+}
+
+enum shm_fifo_buffer_mode shm_fifo_buffer_get_mode(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return ((const struct shm_fifo_buffer *)self)->mode;
+}
+
+void shm_fifo_buffer_dispose(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    struct shm_fifo_buffer *const _self = (struct shm_fifo_buffer *)self;
+
+    munmap(_self->header, _self->region_size);
+    close(_self->fd);
+    *_self = (struct shm_fifo_buffer){
+        .parent = { .vptr = NULL },
+        .header = NULL,
+        .slots = NULL,
+        .fd = -1,
+    };
+}
+
+void shm_fifo_buffer_delete(struct fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    shm_fifo_buffer_dispose(self);
+    free(self);
+}
+
+static bool lock(struct shm_fifo_buffer_header *const header, const bool try_only)
+{
+    const int result = try_only ? pthread_mutex_trylock(&header->mutex) : pthread_mutex_lock(&header->mutex);
+    if (result == EOWNERDEAD) {
+        // The previous owner died inside an enqueue. Indices are only published after
+        // the copy, so its half-written slot is simply not part of the ring.
+        pthread_mutex_consistent(&header->mutex);
+        return true;
+    }
+    return result == 0;
+}
+
+static inline bool is_multiwriter(const struct shm_fifo_buffer *const self)
+{
+    return self->mode == SHM_FIFO_BUFFER_MULTIWRITER;
+}
+
+// Free slots as seen by the producer, refreshing the cached read index if fewer than wanted.
+static size_t writable(const struct shm_fifo_buffer *const self, const size_t current_index, const size_t wanted)
+{
+    struct shm_fifo_buffer_header *const header = self->header;
+    size_t available = self->capacity - (current_index - header->cached_read_index);
+    if (available < wanted) {
+        header->cached_read_index = atomic_load_explicit(&header->read_index, memory_order_acquire);
+        available = self->capacity - (current_index - header->cached_read_index);
+    }
+    return available;
+}
+
+// Queued elements as seen by the consumer, refreshing the cached write index if fewer than wanted.
+static size_t readable(struct shm_fifo_buffer_header *const header, const size_t current_index, const size_t wanted)
+{
+    size_t available = header->cached_write_index - current_index;
+    if (available < wanted) {
+        header->cached_write_index = atomic_load_explicit(&header->write_index, memory_order_acquire);
+        available = header->cached_write_index - current_index;
+    }
+    return available;
+}
+
+// Size of a slot as written by whichever process produced it, never past the slot.
+static inline size_t slot_size(const struct shm_fifo_buffer *const self, const struct lockfree_fifo_buffer_element *const element)
+{
+    const size_t size = element->size;
+    return size < self->element_size ? size : self->element_size;
+}
+
+static size_t put(struct shm_fifo_buffer *const self, const uint8_t *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    struct shm_fifo_buffer_header *const header = self->header;
+    assert(size <= self->element_size);
+
+    const size_t current_index = atomic_load_explicit(&header->write_index, memory_order_relaxed);
+    const size_t available = writable(self, current_index, count);
+
+    const size_t transferred = available < count ? available : count;
+    for (size_t i = 0; i < transferred; i++) {
+        struct lockfree_fifo_buffer_element *const dest = shm_fifo_buffer_element_at(self, current_index + i);
+        copy(dest->buffer, elements + i * size, size);
+        dest->size = size;
+    }
+
+    if (transferred > 0) {
+        atomic_store_explicit(&header->write_index, current_index + transferred, memory_order_release);
+    }
+    return transferred;
+}
+
+static size_t locked_put(struct shm_fifo_buffer *const self, const bool try_only, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    if (!is_multiwriter(self)) {
+        return put(self, elements, size, count, copy);
+    }
+
+    if (!lock(self->header, try_only)) {
+        return 0;
+    }
+    const size_t result = put(self, elements, size, count, copy);
+    pthread_mutex_unlock(&self->header->mutex);
+
+    return result;
+}
+
+size_t shm_fifo_buffer_capacity(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return ((const struct shm_fifo_buffer *)self)->capacity;
+}
+
+size_t shm_fifo_buffer_count(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct shm_fifo_buffer *const _self = (const struct shm_fifo_buffer *)self;
+    const size_t read_index = atomic_load_explicit(&_self->header->read_index, memory_order_acquire);
+    const size_t write_index = atomic_load_explicit(&_self->header->write_index, memory_order_acquire);
+    const size_t count = write_index - read_index;
+    return count < _self->capacity ? count : _self->capacity;
+}
+
+bool shm_fifo_buffer_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return shm_fifo_buffer_enqueue(self, element, size, memcpy);
+}
+
+bool shm_fifo_buffer_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    return locked_put((struct shm_fifo_buffer *)self, false, element, size, 1, copy) == 1;
+}
+
+bool shm_fifo_buffer_try_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return shm_fifo_buffer_try_enqueue(self, element, size, memcpy);
+}
+
+bool shm_fifo_buffer_try_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    return locked_put((struct shm_fifo_buffer *)self, true, element, size, 1, copy) == 1;
+}
+
+size_t shm_fifo_buffer_enqueue_bulk(struct fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+    return locked_put((struct shm_fifo_buffer *)self, false, elements, size, count, copy);
+}
+
+bool shm_fifo_buffer_dequeue_default(struct fifo_buffer *const self, void *const element)
+{
+    return shm_fifo_buffer_dequeue(self, element, memcpy);
+}
+
+bool shm_fifo_buffer_dequeue(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct shm_fifo_buffer *const _self = (struct shm_fifo_buffer *)self;
+    struct shm_fifo_buffer_header *const header = _self->header;
+
+    const size_t current_index = atomic_load_explicit(&header->read_index, memory_order_relaxed);
+    if (readable(header, current_index, 1) == 0) {
+        return false;
+    }
+
+    if (element != NULL && copy != NULL) {
+        const struct lockfree_fifo_buffer_element *const src = shm_fifo_buffer_element_at(_self, current_index);
+        copy(element, src->buffer, slot_size(_self, src));
+    }
+
+    atomic_store_explicit(&header->read_index, current_index + 1, memory_order_release);
+    return true;
+}
+
+size_t shm_fifo_buffer_dequeue_bulk(struct fifo_buffer *const self, void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct shm_fifo_buffer *const _self = (struct shm_fifo_buffer *)self;
+    struct shm_fifo_buffer_header *const header = _self->header;
+
+    const size_t current_index = atomic_load_explicit(&header->read_index, memory_order_relaxed);
+    const size_t available = readable(header, current_index, count);
+
+    const size_t transferred = available < count ? available : count;
+    if (elements != NULL && copy != NULL) {
+        uint8_t *const dest = (uint8_t *)elements;
+        for (size_t i = 0; i < transferred; i++) {
+            const struct lockfree_fifo_buffer_element *const src = shm_fifo_buffer_element_at(_self, current_index + i);
+            const size_t src_size = slot_size(_self, src);
+            copy(dest + i * size, src->buffer, src_size < size ? src_size : size);
+        }
+    }
+
+    if (transferred > 0) {
+        atomic_store_explicit(&header->read_index, current_index + transferred, memory_order_release);
+    }
+    return transferred;
+}
+
+const void *shm_fifo_buffer_peek(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct shm_fifo_buffer *const _self = (const struct shm_fifo_buffer *)self;
+    if (shm_fifo_buffer_is_empty(self)) {
+        return NULL;
+    }
+
+    const size_t current_index = atomic_load_explicit(&_self->header->read_index, memory_order_acquire);
+    return shm_fifo_buffer_element_at(_self, current_index)->buffer;
+}
+
+size_t shm_fifo_buffer_peek_size(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct shm_fifo_buffer *const _self = (const struct shm_fifo_buffer *)self;
+    if (shm_fifo_buffer_is_empty(self)) {
+        return 0;
+    }
+
+    const size_t current_index = atomic_load_explicit(&_self->header->read_index, memory_order_acquire);
+    return slot_size(_self, shm_fifo_buffer_element_at(_self, current_index));
+}
+
+bool shm_fifo_buffer_is_empty(const struct fifo_buffer *const self)
+{
+    return shm_fifo_buffer_count(self) == 0;
+}
+
+bool shm_fifo_buffer_is_full(const struct fifo_buffer *const self)
+{
+    return shm_fifo_buffer_count(self) == shm_fifo_buffer_capacity(self);
+}
+
+void *shm_fifo_buffer_reserve(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    struct shm_fifo_buffer *const _self = (struct shm_fifo_buffer *)self;
+    assert(!is_multiwriter(_self));
+
+    const size_t current_index = atomic_load_explicit(&_self->header->write_index, memory_order_relaxed);
+    if (writable(_self, current_index, 1) == 0) {
+        return NULL;
+    }
+
+    return shm_fifo_buffer_element_at(_self, current_index)->buffer;
+}
+
+void shm_fifo_buffer_commit(struct fifo_buffer *const self, const size_t size)
+{
+    assert(self != NULL);
+
+    struct shm_fifo_buffer *const _self = (struct shm_fifo_buffer *)self;
+    struct shm_fifo_buffer_header *const header = _self->header;
+    assert(!is_multiwriter(_self));
+    assert(size <= _self->element_size);
+
+    const size_t current_index = atomic_load_explicit(&header->write_index, memory_order_relaxed);
+    shm_fifo_buffer_element_at(_self, current_index)->size = size;
+    atomic_store_explicit(&header->write_index, current_index + 1, memory_order_release);
+}
+
+const void *shm_fifo_buffer_acquire(struct fifo_buffer *const self, size_t *const size)
+{
+    assert(self != NULL);
+
+    struct shm_fifo_buffer *const _self = (struct shm_fifo_buffer *)self;
+    const size_t current_index = atomic_load_explicit(&_self->header->read_index, memory_order_relaxed);
+    if (readable(_self->header, current_index, 1) == 0) {
+        return NULL;
+    }
+
+    const struct lockfree_fifo_buffer_element *const head = shm_fifo_buffer_element_at(_self, current_index);
+    if (size != NULL) {
+        *size = slot_size(_self, head);
+    }
+    return head->buffer;
+}
+
+void shm_fifo_buffer_release(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    struct shm_fifo_buffer_header *const header = ((struct shm_fifo_buffer *)self)->header;
+    const size_t current_index = atomic_load_explicit(&header->read_index, memory_order_relaxed);
+    assert(current_index != header->cached_write_index);
+
+    atomic_store_explicit(&header->read_index, current_index + 1, memory_order_release);
+}
@@ -0,0 +1,81 @@
+#ifndef SHM_FIFO_BUFFER_INTERNAL_H
+#define SHM_FIFO_BUFFER_INTERNAL_H
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fifo_buffer.h"
+#include "lockfree_fifo_buffer_internal.h"
+#include "multiwriter_fifo_buffer.h"
+#include "shm_fifo_buffer.h"
+
+#define SHM_FIFO_BUFFER_MAGIC UINT64_C(0x316d68735f71666c) // "lfq_shm1"
+#define SHM_FIFO_BUFFER_VERSION 2U
+
+// Start of the shared region, followed by the slots at slots_offset. Everything in
+// here is position independent: plain integers, address-free lock-free atomics and a
+// process-shared mutex. ready is set last by the creator and checked by attachers.
+struct shm_fifo_buffer_header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t mode;
+    uint64_t element_size;
+    uint64_t capacity;
+    uint64_t element_stride;
+    uint64_t slots_offset;
+    uint64_t region_size;
+    atomic_uint ready;
+    pthread_mutex_t mutex;
+
+    // free-running counters as in lockfree_fifo_buffer
+    // producer side
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t write_index;
+    size_t cached_read_index;
+
+    // consumer side
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t read_index;
+    size_t cached_write_index;
+};
+
+// Per-process handle onto a mapped region. The geometry is copied out of the header
+// once it has been validated, so a peer rewriting the header cannot move slot
+// addressing outside the mapping.
+struct shm_fifo_buffer {
+    union {
+        struct fifo_buffer parent;
+        struct multiwriter_fifo_buffer multiwriter;
+    };
+    struct shm_fifo_buffer_header *header;
+    uint8_t *slots;
+    size_t region_size;
+    size_t element_size;
+    size_t capacity;
+    size_t element_stride;
+    enum shm_fifo_buffer_mode mode;
+    int fd;
+};
+
+static inline struct lockfree_fifo_buffer_element *shm_fifo_buffer_element_at(const struct shm_fifo_buffer *const self, const size_t index)
+{
+    return (struct lockfree_fifo_buffer_element *)(self->slots + (index & (self->capacity - 1)) * self->element_stride);
+}
+
+size_t shm_fifo_buffer_capacity(const struct fifo_buffer *self);
+size_t shm_fifo_buffer_count(const struct fifo_buffer *self);
+bool shm_fifo_buffer_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool shm_fifo_buffer_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+bool shm_fifo_buffer_try_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool shm_fifo_buffer_try_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+size_t shm_fifo_buffer_enqueue_bulk(struct fifo_buffer *self, const void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+bool shm_fifo_buffer_dequeue_default(struct fifo_buffer *self, void *element);
+bool shm_fifo_buffer_dequeue(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
+size_t shm_fifo_buffer_dequeue_bulk(struct fifo_buffer *self, void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+const void *shm_fifo_buffer_peek(const struct fifo_buffer *self);
+size_t shm_fifo_buffer_peek_size(const struct fifo_buffer *self);
+bool shm_fifo_buffer_is_empty(const struct fifo_buffer *self);
+bool shm_fifo_buffer_is_full(const struct fifo_buffer *self);
+
+#endif // SHM_FIFO_BUFFER_INTERNAL_H
@@ -0,0 +1,318 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "stream_fifo_buffer.h"
+#include "fifo_buffer_stats_internal.h"
+#include "stream_fifo_buffer_internal.h"
+
+static const struct fifo_buffer_interface vtable = {
+    .dispose = stream_fifo_buffer_dispose,
+    .free = stream_fifo_buffer_delete,
+    .capacity = stream_fifo_buffer_capacity,
+    .count = stream_fifo_buffer_count,
+    .enqueue_default = stream_fifo_buffer_enqueue_default,
+    .enqueue = stream_fifo_buffer_enqueue,
+    .dequeue_default = stream_fifo_buffer_dequeue_default,
+    .dequeue = stream_fifo_buffer_dequeue,
+    .enqueue_bulk = stream_fifo_buffer_enqueue_bulk,
+    .dequeue_bulk = stream_fifo_buffer_dequeue_bulk,
+    .peek = stream_fifo_buffer_peek,
+    .peek_size = stream_fifo_buffer_peek_size,
+    .is_empty = stream_fifo_buffer_is_empty,
+    .is_full = stream_fifo_buffer_is_full,
+    .stats_snapshot = fifo_buffer_stats_unavailable,
+};
+
+static inline size_t round_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline size_t record_length(const size_t size)
+{
+    return round_up(sizeof(struct stream_record) + size, alignof(struct stream_record));
+}
+
+// Bytes a record of the given size occupies when written at position, including the
+// padding record that is needed when it would otherwise straddle the end of the arena.
+static inline size_t placement_length(const struct stream_fifo_buffer *const self, const size_t position, const size_t size)
+{
+    const size_t length = record_length(size);
+    const size_t tail = self->arena_size - (position & (self->arena_size - 1));
+    return length <= tail ? length : tail + length;
+}
+
+// Largest payload accepted. A record of at most half the arena fits an empty ring at any
+// write position, so a drained ring never rejects it.
+static inline size_t max_record_size(const struct stream_fifo_buffer *const self)
+{
+    return self->arena_size / 2 - sizeof(struct stream_record);
+}
+
+bool stream_fifo_buffer_initialize(struct stream_fifo_buffer *const self, const size_t arena_size)
+{
+    assert(self != NULL);
+
+    if (arena_size > (SIZE_MAX >> 1)) {
+        return false;
+    }
+
+    size_t aligned_size = LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE;
+    while (aligned_size < arena_size) {
+        aligned_size <<= 1;
+    }
+
+    uint8_t *const arena = (uint8_t *)aligned_alloc(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE, aligned_size);
+    if (arena == NULL) {
+        return false;
+    }
+
+    self->parent.vptr = &vtable;
+    self->arena_size = aligned_size;
+    self->arena = arena;
+    atomic_init(&self->write_position, 0);
+    self->cached_read_position = 0;
+    atomic_init(&self->enqueued, 0);
+    atomic_init(&self->read_position, 0);
+    self->cached_write_position = 0;
+    atomic_init(&self->dequeued, 0);
+
+    return true;
+}
+
+struct stream_fifo_buffer *stream_fifo_buffer_new(const size_t arena_size)
+{
+    struct stream_fifo_buffer *const buf = aligned_alloc(alignof(struct stream_fifo_buffer), sizeof(struct stream_fifo_buffer));
+    if (buf == NULL) {
+        return NULL;
+    }
+
+    if (!stream_fifo_buffer_initialize(buf, arena_size)) {
+        free(buf);
+        return NULL;
+    }
+
+    return buf;
+}
+
+void stream_fifo_buffer_dispose(struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    struct stream_fifo_buffer *const _self = (struct stream_fifo_buffer *)self;
+
+    free(_self->arena);
+    _self->parent.vptr = NULL;
+    _self->arena_size = 0;
+    _self->arena = NULL;
+}
+
+void stream_fifo_buffer_delete(struct fifo_buffer *const self)
+{
+    if (self == NULL) {
+        return;
+    }
+
+    stream_fifo_buffer_dispose(self);
+    free(self);
+}
+
+size_t stream_fifo_buffer_capacity(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+    return ((const struct stream_fifo_buffer *)self)->arena_size;
+}
+
+size_t stream_fifo_buffer_count(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct stream_fifo_buffer *const _self = (const struct stream_fifo_buffer *)self;
+    const size_t dequeued = atomic_load_explicit(&_self->dequeued, memory_order_acquire);
+    const size_t enqueued = atomic_load_explicit(&_self->enqueued, memory_order_acquire);
+    return enqueued - dequeued;
+}
+
+// Writes one record at position and returns the position that follows it, or position
+// itself when the record does not fit into the space left before limit.
+static size_t put_record(struct stream_fifo_buffer *const self, const size_t position, const size_t limit, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    if (size > max_record_size(self)) {
+        return position;
+    }
+
+    const size_t length = placement_length(self, position, size);
+    if (length > limit - position) {
+        return position;
+    }
+
+    size_t record_position = position;
+    if (length != record_length(size)) {
+        stream_fifo_buffer_record_at(self, position)->size = STREAM_RECORD_PADDING;
+        record_position += length - record_length(size);
+    }
+
+    struct stream_record *const dest = stream_fifo_buffer_record_at(self, record_position);
+    copy(dest->buffer, element, size);
+    dest->size = size;
+    return position + length;
+}
+
+bool stream_fifo_buffer_enqueue_default(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return stream_fifo_buffer_enqueue(self, element, size, memcpy);
+}
+
+bool stream_fifo_buffer_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size, void *(*const copy)(void *, const void *, size_t))
+{
+    return stream_fifo_buffer_enqueue_bulk(self, element, size, 1, copy) == 1;
+}
+
+size_t stream_fifo_buffer_enqueue_bulk(struct fifo_buffer *const self, const void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct stream_fifo_buffer *const _self = (struct stream_fifo_buffer *)self;
+    assert(_self->arena != NULL);
+
+    const size_t current_position = atomic_load_explicit(&_self->write_position, memory_order_relaxed);
+    const uint8_t *const src = (const uint8_t *)elements;
+
+    size_t position = current_position;
+    size_t transferred = 0;
+    while (transferred < count) {
+        size_t next_position = put_record(_self, position, _self->cached_read_position + _self->arena_size, src + transferred * size, size, copy);
+        if (next_position == position) {
+            _self->cached_read_position = atomic_load_explicit(&_self->read_position, memory_order_acquire);
+            next_position = put_record(_self, position, _self->cached_read_position + _self->arena_size, src + transferred * size, size, copy);
+            if (next_position == position) {
+                break;
+            }
+        }
+        position = next_position;
+        transferred++;
+    }
+
+    if (transferred > 0) {
+        // the record count has to lead the position so that count() never observes more dequeues than enqueues
+        atomic_store_explicit(&_self->enqueued, atomic_load_explicit(&_self->enqueued, memory_order_relaxed) + transferred, memory_order_relaxed);
+        atomic_store_explicit(&_self->write_position, position, memory_order_release);
+    }
+    return transferred;
+}
+
+bool stream_fifo_buffer_dequeue_default(struct fifo_buffer *const self, void *const element)
+{
+    return stream_fifo_buffer_dequeue(self, element, memcpy);
+}
+
+bool stream_fifo_buffer_dequeue(struct fifo_buffer *const self, void *const element, void *(*const copy)(void *, const void *, size_t))
+{
+    return stream_fifo_buffer_dequeue_bulk(self, element, max_record_size((struct stream_fifo_buffer *)self), 1, copy) == 1;
+}
+
+// Skips a padding record, if any, and returns the position of the record at position.
+static inline size_t head_position(const struct stream_fifo_buffer *const self, const size_t position)
+{
+    if (stream_fifo_buffer_record_at(self, position)->size != STREAM_RECORD_PADDING) {
+        return position;
+    }
+    return position + self->arena_size - (position & (self->arena_size - 1));
+}
+
+size_t stream_fifo_buffer_dequeue_bulk(struct fifo_buffer *const self, void *const elements, const size_t size, const size_t count, void *(*const copy)(void *, const void *, size_t))
+{
+    assert(self != NULL);
+
+    struct stream_fifo_buffer *const _self = (struct stream_fifo_buffer *)self;
+    assert(_self->arena != NULL);
+
+    const size_t current_position = atomic_load_explicit(&_self->read_position, memory_order_relaxed);
+    uint8_t *const dest = (uint8_t *)elements;
+
+    size_t position = current_position;
+    size_t transferred = 0;
+    while (transferred < count) {
+        if (position == _self->cached_write_position) {
+            _self->cached_write_position = atomic_load_explicit(&_self->write_position, memory_order_acquire);
+            if (position == _self->cached_write_position) {
+                break;
+            }
+        }
+
+        position = head_position(_self, position);
+        const struct stream_record *const src = stream_fifo_buffer_record_at(_self, position);
+        if (dest != NULL && copy != NULL) {
+            copy(dest + transferred * size, src->buffer, src->size < size ? src->size : size);
+        }
+        position += record_length(src->size);
+        transferred++;
+    }
+
+    if (transferred > 0) {
+        atomic_store_explicit(&_self->dequeued, atomic_load_explicit(&_self->dequeued, memory_order_relaxed) + transferred, memory_order_release);
+        atomic_store_explicit(&_self->read_position, position, memory_order_release);
+    }
+    return transferred;
+}
+
+const void *stream_fifo_buffer_peek(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct stream_fifo_buffer *const _self = (const struct stream_fifo_buffer *)self;
+    assert(_self->arena != NULL);
+
+    if (stream_fifo_buffer_is_empty(self)) {
+        return NULL;
+    }
+
+    const size_t position = atomic_load_explicit(&_self->read_position, memory_order_relaxed);
+    return stream_fifo_buffer_record_at(_self, head_position(_self, position))->buffer;
+}
+
+size_t stream_fifo_buffer_peek_size(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct stream_fifo_buffer *const _self = (const struct stream_fifo_buffer *)self;
+    assert(_self->arena != NULL);
+
+    if (stream_fifo_buffer_is_empty(self)) {
+        return 0;
+    }
+
+    const size_t position = atomic_load_explicit(&_self->read_position, memory_order_relaxed);
+    return stream_fifo_buffer_record_at(_self, head_position(_self, position))->size;
+}
+
+bool stream_fifo_buffer_is_empty(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct stream_fifo_buffer *const _self = (const struct stream_fifo_buffer *)self;
+    assert(_self->arena != NULL);
+
+    const size_t write_position = atomic_load_explicit(&_self->write_position, memory_order_acquire);
+    const size_t read_position = atomic_load_explicit(&_self->read_position, memory_order_acquire);
+
+    return write_position == read_position;
+}
+
+bool stream_fifo_buffer_is_full(const struct fifo_buffer *const self)
+{
+    assert(self != NULL);
+
+    const struct stream_fifo_buffer *const _self = (const struct stream_fifo_buffer *)self;
+    assert(_self->arena != NULL);
+
+    // full once not even an empty record fits, wherever the write position is
+    const size_t write_position = atomic_load_explicit(&_self->write_position, memory_order_acquire);
+    const size_t read_position = atomic_load_explicit(&_self->read_position, memory_order_acquire);
+
+    return _self->arena_size - (write_position - read_position) < placement_length(_self, write_position, 0);
+}
@@ -0,0 +1,58 @@
+#ifndef STREAM_FIFO_BUFFER_INTERNAL_H
+#define STREAM_FIFO_BUFFER_INTERNAL_H
+
+#include <stddef.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#include "fifo_buffer.h"
+#include "lockfree_fifo_buffer_internal.h"
+#include "stream_fifo_buffer.h"
+
+// Length prefix of a record. A record whose size is STREAM_RECORD_PADDING fills the
+// rest of the arena so that the next record starts contiguously at offset zero.
+struct stream_record {
+    size_t size;
+    alignas(max_align_t) uint8_t buffer[];
+};
+
+#define STREAM_RECORD_PADDING SIZE_MAX
+
+struct stream_fifo_buffer {
+    struct fifo_buffer parent;
+    size_t arena_size;
+    uint8_t *arena;
+
+    // producer side: positions are free-running byte offsets
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t write_position;
+    size_t cached_read_position;
+    atomic_size_t enqueued;
+
+    // consumer side
+    alignas(LOCKFREE_FIFO_BUFFER_CACHE_LINE_SIZE) atomic_size_t read_position;
+    size_t cached_write_position;
+    atomic_size_t dequeued;
+};
+
+static inline struct stream_record *stream_fifo_buffer_record_at(const struct stream_fifo_buffer *const self, const size_t position)
+{
+    return (struct stream_record *)(self->arena + (position & (self->arena_size - 1)));
+}
+
+bool stream_fifo_buffer_initialize(struct stream_fifo_buffer *self, size_t arena_size);
+size_t stream_fifo_buffer_capacity(const struct fifo_buffer *self);
+size_t stream_fifo_buffer_count(const struct fifo_buffer *self);
+bool stream_fifo_buffer_enqueue_default(struct fifo_buffer *self, const void *element, size_t size);
+bool stream_fifo_buffer_enqueue(struct fifo_buffer *self, const void *element, size_t size, void *(*copy)(void *, const void *, size_t));
+bool stream_fifo_buffer_dequeue_default(struct fifo_buffer *self, void *element);
+bool stream_fifo_buffer_dequeue(struct fifo_buffer *self, void *element, void *(*copy)(void *, const void *, size_t));
+size_t stream_fifo_buffer_enqueue_bulk(struct fifo_buffer *self, const void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+size_t stream_fifo_buffer_dequeue_bulk(struct fifo_buffer *self, void *elements, size_t size, size_t count, void *(*copy)(void *, const void *, size_t));
+const void *stream_fifo_buffer_peek(const struct fifo_buffer *self);
+size_t stream_fifo_buffer_peek_size(const struct fifo_buffer *self);
+bool stream_fifo_buffer_is_empty(const struct fifo_buffer *self);
+bool stream_fifo_buffer_is_full(const struct fifo_buffer *self);
+
+#endif // STREAM_FIFO_BUFFER_INTERNAL_H
@@ -0,0 +1,278 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "broadcast_fifo_buffer.h"
+#include "fifo_buffer_stats.h"
+}
+
+TEST(broadcast_fifo_buffer_initialize_test, it_has_power_of_two_capacity)
+{
+    for (size_t i = 0; i < 130; i++) {
+        auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), i, 4);
+        ASSERT_NE(ring, nullptr);
+
+        const size_t capacity = broadcast_fifo_buffer_capacity(ring);
+        ASSERT_GE(capacity, i);
+        ASSERT_EQ(capacity & (capacity - 1), 0);
+        broadcast_fifo_buffer_delete(ring);
+    }
+}
+
+TEST(broadcast_fifo_buffer_enqueue_test, it_never_fills_up_without_consumers)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 8, 4);
+
+    for (size_t i = 0; i < broadcast_fifo_buffer_capacity(ring) * 4; i++) {
+        ASSERT_TRUE(broadcast_fifo_buffer_enqueue_default(ring, &i, sizeof(i)));
+    }
+    ASSERT_FALSE(broadcast_fifo_buffer_is_full(ring));
+
+    broadcast_fifo_buffer_delete(ring);
+}
+
+TEST(broadcast_fifo_buffer_dequeue_test, it_delivers_every_element_to_every_consumer)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 16, 3);
+    const size_t capacity = broadcast_fifo_buffer_capacity(ring);
+
+    std::vector<broadcast_fifo_buffer_consumer *> consumers;
+    for (size_t i = 0; i < 3; i++) {
+        consumers.push_back(broadcast_fifo_buffer_register(ring));
+        ASSERT_NE(consumers.back(), nullptr);
+    }
+    ASSERT_EQ(broadcast_fifo_buffer_register(ring), nullptr);
+
+    for (size_t i = 0; i < capacity; i++) {
+        ASSERT_TRUE(broadcast_fifo_buffer_enqueue_default(ring, &i, sizeof(i)));
+    }
+
+    for (auto const consumer: consumers) {
+        ASSERT_EQ(broadcast_fifo_buffer_count(consumer), capacity);
+        for (size_t i = 0; i < capacity; i++) {
+            size_t element = SIZE_MAX;
+            ASSERT_TRUE(broadcast_fifo_buffer_dequeue_default(consumer, &element));
+            ASSERT_EQ(element, i);
+        }
+        ASSERT_TRUE(broadcast_fifo_buffer_is_empty(consumer));
+        ASSERT_FALSE(broadcast_fifo_buffer_dequeue_default(consumer, nullptr));
+        broadcast_fifo_buffer_unregister(consumer);
+    }
+
+    broadcast_fifo_buffer_delete(ring);
+}
+
+TEST(broadcast_fifo_buffer_dequeue_test, it_shares_one_slot_between_consumers)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 4, 2);
+    auto const first = broadcast_fifo_buffer_register(ring);
+    auto const second = broadcast_fifo_buffer_register(ring);
+
+    const size_t value = 42;
+    ASSERT_TRUE(broadcast_fifo_buffer_enqueue_default(ring, &value, sizeof(value)));
+
+    size_t first_size = 0;
+    size_t second_size = 0;
+    const void *const first_element = broadcast_fifo_buffer_acquire(first, &first_size);
+    const void *const second_element = broadcast_fifo_buffer_acquire(second, &second_size);
+    ASSERT_NE(first_element, nullptr);
+    ASSERT_EQ(first_element, second_element);
+    ASSERT_EQ(first_size, sizeof(size_t));
+    ASSERT_EQ(*reinterpret_cast<const size_t *>(first_element), 42);
+
+    broadcast_fifo_buffer_release(first, 1);
+    broadcast_fifo_buffer_release(second, 1);
+    ASSERT_EQ(broadcast_fifo_buffer_acquire(first, nullptr), nullptr);
+
+    broadcast_fifo_buffer_unregister(first);
+    broadcast_fifo_buffer_unregister(second);
+    broadcast_fifo_buffer_delete(ring);
+}
+
+TEST(broadcast_fifo_buffer_enqueue_test, it_waits_for_the_slowest_consumer)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 8, 2);
+    const size_t capacity = broadcast_fifo_buffer_capacity(ring);
+    auto const fast = broadcast_fifo_buffer_register(ring);
+    auto const slow = broadcast_fifo_buffer_register(ring);
+
+    for (size_t i = 0; i < capacity; i++) {
+        ASSERT_TRUE(broadcast_fifo_buffer_enqueue_default(ring, &i, sizeof(i)));
+    }
+    ASSERT_TRUE(broadcast_fifo_buffer_is_full(ring));
+
+    while (broadcast_fifo_buffer_dequeue_default(fast, nullptr)) {
+    }
+    ASSERT_FALSE(broadcast_fifo_buffer_enqueue_default(ring, &capacity, sizeof(capacity)));
+    ASSERT_EQ(broadcast_fifo_buffer_reserve(ring), nullptr);
+
+    ASSERT_TRUE(broadcast_fifo_buffer_dequeue_default(slow, nullptr));
+    ASSERT_TRUE(broadcast_fifo_buffer_enqueue_default(ring, &capacity, sizeof(capacity)));
+    ASSERT_TRUE(broadcast_fifo_buffer_is_full(ring));
+
+    // the producer stops waiting for a consumer once it unregisters
+    broadcast_fifo_buffer_unregister(slow);
+    ASSERT_FALSE(broadcast_fifo_buffer_is_full(ring));
+
+    broadcast_fifo_buffer_unregister(fast);
+    broadcast_fifo_buffer_delete(ring);
+}
+
+TEST(broadcast_fifo_buffer_register_test, it_starts_new_consumers_at_the_next_element)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 8, 1);
+
+    for (size_t i = 0; i < 3; i++) {
+        ASSERT_TRUE(broadcast_fifo_buffer_enqueue_default(ring, &i, sizeof(i)));
+    }
+
+    auto consumer = broadcast_fifo_buffer_register(ring);
+    ASSERT_TRUE(broadcast_fifo_buffer_is_empty(consumer));
+
+    const size_t value = 3;
+    ASSERT_TRUE(broadcast_fifo_buffer_enqueue_default(ring, &value, sizeof(value)));
+    size_t element = SIZE_MAX;
+    ASSERT_TRUE(broadcast_fifo_buffer_dequeue_default(consumer, &element));
+    ASSERT_EQ(element, 3);
+
+    // the slot is reusable after unregistering
+    broadcast_fifo_buffer_unregister(consumer);
+    consumer = broadcast_fifo_buffer_register(ring);
+    ASSERT_NE(consumer, nullptr);
+    ASSERT_TRUE(broadcast_fifo_buffer_is_empty(consumer));
+
+    broadcast_fifo_buffer_unregister(consumer);
+    broadcast_fifo_buffer_delete(ring);
+}
+
+TEST(broadcast_fifo_buffer_concurrent_test, it_delivers_every_element_to_concurrent_consumers)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 64, 3);
+    constexpr size_t total = 100000;
+
+    std::vector<broadcast_fifo_buffer_consumer *> consumers;
+    for (size_t i = 0; i < 3; i++) {
+        consumers.push_back(broadcast_fifo_buffer_register(ring));
+    }
+
+    std::vector<std::future<void>> readers;
+    for (auto const consumer: consumers) {
+        readers.push_back(std::async(std::launch::async, [consumer] () {
+            for (size_t i = 0; i < total; i++) {
+                size_t element = SIZE_MAX;
+                while (!broadcast_fifo_buffer_dequeue_default(consumer, &element)) {
+                    std::this_thread::yield();
+                }
+                ASSERT_EQ(element, i);
+            }
+        }));
+    }
+
+    for (size_t i = 0; i < total; i++) {
+        while (!broadcast_fifo_buffer_enqueue_default(ring, &i, sizeof(i))) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto &reader: readers) {
+        reader.wait();
+    }
+
+    for (auto const consumer: consumers) {
+        broadcast_fifo_buffer_unregister(consumer);
+    }
+    broadcast_fifo_buffer_delete(ring);
+}
+
+TEST(broadcast_fifo_buffer_concurrent_test, it_lets_consumers_join_and_leave_while_producing)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 16, 2);
+    constexpr size_t total = 200000;
+    std::atomic<bool> done { false };
+
+    auto reader = std::async(std::launch::async, [ring, &done] () {
+        while (!done.load(std::memory_order_acquire)) {
+            auto const consumer = broadcast_fifo_buffer_register(ring);
+            ASSERT_NE(consumer, nullptr);
+
+            // whatever a consumer joins at, it sees consecutive elements from there
+            size_t last = SIZE_MAX;
+            for (size_t received = 0; received < 100 && !done.load(std::memory_order_acquire);) {
+                size_t element = SIZE_MAX;
+                if (!broadcast_fifo_buffer_dequeue_default(consumer, &element)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                ASSERT_TRUE(last == SIZE_MAX || element == last + 1);
+                last = element;
+                received++;
+            }
+            broadcast_fifo_buffer_unregister(consumer);
+        }
+    });
+
+    for (size_t i = 0; i < total; i++) {
+        while (!broadcast_fifo_buffer_enqueue_default(ring, &i, sizeof(i))) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    reader.wait();
+
+    broadcast_fifo_buffer_delete(ring);
+}
+
+#if defined(FIFO_BUFFER_STATS)
+TEST(broadcast_fifo_buffer_stats_test, it_reports_per_consumer_counters)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 4, 2);
+    auto const first = broadcast_fifo_buffer_register(ring);
+    auto const second = broadcast_fifo_buffer_register(ring);
+
+    for (size_t i = 0; i < 3; i++) {
+        broadcast_fifo_buffer_enqueue_default(ring, &i, sizeof(i));
+    }
+    while (broadcast_fifo_buffer_dequeue_default(first, nullptr)) {
+    }
+    broadcast_fifo_buffer_dequeue_default(second, nullptr);
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(broadcast_fifo_buffer_stats_snapshot(first, &stats));
+    ASSERT_EQ(stats.enqueued, 3);
+    ASSERT_EQ(stats.dequeued, 3);
+    ASSERT_EQ(stats.empty_polls, 1);
+    ASSERT_EQ(stats.high_water_mark, 3);
+    ASSERT_TRUE(broadcast_fifo_buffer_stats_snapshot(second, &stats));
+    ASSERT_EQ(stats.dequeued, 1);
+    ASSERT_EQ(stats.empty_polls, 0);
+    ASSERT_EQ(stats.high_water_mark, 3);
+
+    broadcast_fifo_buffer_unregister(first);
+    broadcast_fifo_buffer_unregister(second);
+    broadcast_fifo_buffer_delete(ring);
+}
+
+TEST(broadcast_fifo_buffer_stats_test, it_keeps_a_low_high_water_mark_when_consumers_keep_up)
+{
+    auto const ring = broadcast_fifo_buffer_new(sizeof(size_t), 1024, 1);
+    auto const consumer = broadcast_fifo_buffer_register(ring);
+
+    for (size_t i = 0; i < 2000; i++) {
+        ASSERT_TRUE(broadcast_fifo_buffer_enqueue_default(ring, &i, sizeof(i)));
+        ASSERT_TRUE(broadcast_fifo_buffer_dequeue_default(consumer, nullptr));
+    }
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(broadcast_fifo_buffer_stats_snapshot(consumer, &stats));
+    ASSERT_EQ(stats.enqueued, 2000);
+    ASSERT_EQ(stats.high_water_mark, 1);
+
+    broadcast_fifo_buffer_unregister(consumer);
+    broadcast_fifo_buffer_delete(ring);
+}
+#endif
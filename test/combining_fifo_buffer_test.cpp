@@ -0,0 +1,209 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "fifo_buffer_stats.h"
+#include "multiwriter_fifo_buffer.h"
+}
+
+class TestClass {
+private:
+    std::size_t dummy_;
+public:
+    explicit TestClass(std::size_t size): dummy_(size)
+    {
+        // do nothing
+    }
+
+    TestClass(const TestClass &rhs) = default;
+    TestClass(TestClass &&rhs) = default;
+    TestClass &operator=(const TestClass &rhs) = default;
+    TestClass &operator=(TestClass &&rhs) = default;
+
+    bool operator==(const TestClass &rhs) const { return this->dummy_ == rhs.dummy_; }
+    [[nodiscard]] std::size_t dummy() const { return this->dummy_; }
+};
+
+const auto default_copy = [] (void *to, const void *from, size_t) -> void * {
+    *reinterpret_cast<TestClass *>(to) = *reinterpret_cast<const TestClass *>(from);
+    return to;
+};
+
+static fifo_buffer *new_combining(const size_t count)
+{
+    return reinterpret_cast<fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), count, MULTIWRITER_FIFO_BUFFER_COMBINING));
+}
+
+TEST(combining_fifo_buffer_initialize_test, it_is_initializable)
+{
+    auto const queue = new_combining(12);
+
+    ASSERT_NE(queue, nullptr);
+    ASSERT_GE(queue->vptr->capacity(queue), 12);
+    ASSERT_TRUE(queue->vptr->is_empty(queue));
+
+    queue->vptr->free(queue);
+}
+
+TEST(combining_fifo_buffer_enqueue_default_test, it_cannot_enqueue_into_full_queue)
+{
+    auto const queue = new_combining(14);
+
+    for (size_t i = 0; i < queue->vptr->capacity(queue); i++) {
+        const TestClass element(i);
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+    }
+    const TestClass element(0);
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+    ASSERT_FALSE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+    ASSERT_FALSE(reinterpret_cast<multiwriter_fifo_buffer *>(queue)->vptr->try_enqueue_default(queue, &element, sizeof(element)));
+
+    ASSERT_TRUE(queue->vptr->dequeue_default(queue, nullptr));
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+
+    queue->vptr->free(queue);
+}
+
+TEST(combining_fifo_buffer_try_enqueue_default_test, it_is_reachable_through_the_public_multiwriter_functions)
+{
+    auto const queue = new_combining(4);
+
+    for (size_t i = 0; i < queue->vptr->capacity(queue); i++) {
+        const TestClass element(i);
+        if (i % 2 == 0) {
+            ASSERT_TRUE(multiwriter_fifo_buffer_try_enqueue_default(queue, &element, sizeof(element)));
+        } else {
+            ASSERT_TRUE(multiwriter_fifo_buffer_try_enqueue(queue, &element, sizeof(element), default_copy));
+        }
+    }
+    const TestClass element(0);
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+    ASSERT_FALSE(multiwriter_fifo_buffer_try_enqueue_default(queue, &element, sizeof(element)));
+    ASSERT_FALSE(multiwriter_fifo_buffer_try_enqueue(queue, &element, sizeof(element), default_copy));
+
+    for (size_t i = 0; i < queue->vptr->capacity(queue); i++) {
+        TestClass dequeued(SIZE_MAX);
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &dequeued));
+        ASSERT_EQ(dequeued, TestClass(i));
+    }
+
+    multiwriter_fifo_buffer_delete(queue);
+}
+
+TEST(combining_fifo_buffer_enqueue_bulk_test, it_enqueues_elements_only_into_free_slots)
+{
+    auto const queue = new_combining(14);
+
+    std::vector<TestClass> elements;
+    for (size_t i = 0; i < queue->vptr->capacity(queue) * 2; i++) {
+        elements.emplace_back(i);
+    }
+
+    const size_t enqueued = queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy);
+    ASSERT_EQ(enqueued, queue->vptr->capacity(queue));
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+    ASSERT_EQ(queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy), 0);
+
+    for (size_t i = 0; i < enqueued; i++) {
+        TestClass dequeued(0);
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &dequeued));
+        ASSERT_EQ(dequeued, elements.at(i));
+    }
+
+    queue->vptr->free(queue);
+}
+
+TEST(combining_fifo_buffer_dequeue_bulk_test, it_dequeues_queued_elements_order_by_first_in_first_out)
+{
+    auto const queue = new_combining(14);
+
+    std::vector<TestClass> elements;
+    std::vector<TestClass> dequeues;
+    for (size_t i = 0; i < 65535; i++) {
+        elements.emplace_back(i);
+    }
+
+    size_t enqueued = 0;
+    while (dequeues.size() != elements.size()) {
+        enqueued += queue->vptr->enqueue_bulk(queue, elements.data() + enqueued, sizeof(TestClass), std::min<size_t>(elements.size() - enqueued, 5), default_copy);
+
+        std::vector<TestClass> buffer(3, TestClass(0));
+        const size_t dequeued = queue->vptr->dequeue_bulk(queue, buffer.data(), sizeof(TestClass), buffer.size(), default_copy);
+        dequeues.insert(dequeues.end(), buffer.begin(), buffer.begin() + dequeued);
+    }
+
+    ASSERT_EQ(dequeues, elements);
+
+    queue->vptr->free(queue);
+}
+
+TEST(combining_fifo_buffer_contensivity_test, it_never_loses_elements_when_more_writers_than_records)
+{
+    // more writers than request records, so some of them have to combine for themselves
+    constexpr std::size_t writers = 40;
+    constexpr std::size_t tail = 2048;
+    auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 256, MULTIWRITER_FIFO_BUFFER_COMBINING));
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        std::vector<size_t> expected(writers, 0);
+        for (size_t i = 0; i < writers * tail; i++) {
+            TestClass element(0);
+            while (!queue->vptr->dequeue_default((fifo_buffer *)queue, &element)) {
+                std::this_thread::yield();
+            }
+            const size_t writer = element.dummy() / tail;
+            ASSERT_EQ(element.dummy() % tail, expected.at(writer));
+            expected.at(writer) += 1;
+        }
+        ASSERT_TRUE(queue->vptr->is_empty((fifo_buffer *)queue));
+    });
+    std::vector<std::future<void>> producers;
+    for (size_t w = 0; w < writers; w++) {
+        producers.push_back(std::async(std::launch::async, [queue, w] () {
+            for (size_t i = 0; i < tail; i++) {
+                const TestClass element(w * tail + i);
+                if (w % 2 == 0) {
+                    while (!queue->vptr->enqueue_default((fifo_buffer *)queue, &element, sizeof(element))) {
+                        std::this_thread::yield();
+                    }
+                } else {
+                    while (!queue->vptr->try_enqueue_default((fifo_buffer *)queue, &element, sizeof(element))) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }));
+    }
+
+    for (auto &producer: producers) {
+        producer.wait();
+    }
+    consumer.wait();
+
+    queue->vptr->free((fifo_buffer *)queue);
+}
+
+#if defined(FIFO_BUFFER_STATS)
+TEST(combining_fifo_buffer_stats_test, it_keeps_a_low_high_water_mark_when_the_consumer_keeps_up)
+{
+    auto const queue = new_combining(1024);
+
+    const TestClass element(128);
+    for (size_t i = 0; i < 2000; i++) {
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, nullptr));
+    }
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(queue->vptr->stats_snapshot(queue, &stats));
+    EXPECT_EQ(stats.enqueued, 2000);
+    EXPECT_EQ(stats.high_water_mark, 1);
+
+    queue->vptr->free(queue);
+}
+#endif
@@ -0,0 +1,314 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+extern "C" {
+#include "concurrent_fifo_buffer.h"
+}
+
+class TestClass {
+private:
+    std::size_t dummy_;
+public:
+    explicit TestClass(std::size_t size): dummy_(size)
+    {
+        // do nothing
+    }
+
+    TestClass(const TestClass &rhs) = default;
+    TestClass(TestClass &&rhs) = default;
+    TestClass &operator=(const TestClass &rhs) = default;
+    TestClass &operator=(TestClass &&rhs) = default;
+
+    bool operator==(const TestClass &rhs) const { return this->dummy_ == rhs.dummy_; }
+    [[nodiscard]] std::size_t dummy() const { return this->dummy_; }
+};
+
+const auto default_copy = [] (void *to, const void *from, size_t) -> void * {
+    *reinterpret_cast<TestClass *>(to) = *reinterpret_cast<const TestClass *>(from);
+    return to;
+};
+
+TEST(concurrent_fifo_buffer_initialize_test, it_is_initializable)
+{
+    auto const queue = reinterpret_cast<fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), 12));
+
+    ASSERT_NE(queue, nullptr);
+
+    queue->vptr->free(queue);
+}
+
+TEST(concurrent_fifo_buffer_initialize_test, it_has_enough_capacity)
+{
+    for (size_t i = 0; i < 65535; i += 1023) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), i));
+        ASSERT_GE(queue->vptr->capacity(queue), i);
+        queue->vptr->free(queue);
+    }
+}
+
+TEST(concurrent_fifo_buffer_initialize_test, it_is_empty_after_initialization)
+{
+    for (size_t i = 0; i < 128; i++) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), i));
+        ASSERT_TRUE(queue->vptr->is_empty(queue));
+        ASSERT_EQ(queue->vptr->count(queue), 0);
+        queue->vptr->free(queue);
+    }
+}
+
+TEST(concurrent_fifo_buffer_enqueue_default_test, it_cannot_enqueue_into_full_queue)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    const TestClass element(128);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    ASSERT_GE(queue->vptr->count(queue), required_capacity);
+    ASSERT_FALSE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+}
+
+TEST(concurrent_fifo_buffer_dequeue_default_test, it_cannot_dequeue_from_empty_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), 14));
+
+    ASSERT_FALSE(queue->vptr->dequeue_default(queue, nullptr));
+}
+
+TEST(concurrent_fifo_buffer_dequeue_default_test, it_dequeues_queued_elements_order_by_first_in_first_out)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    std::vector<TestClass> elements;
+    std::vector<TestClass> dequeues;
+    elements.reserve(65535);
+    dequeues.reserve(65535);
+
+    while (elements.size() != elements.capacity()) {
+        for (size_t i = elements.size(); i < elements.capacity(); i++) {
+            if (queue->vptr->is_full(queue)) {
+                break;
+            }
+            elements.emplace_back(i);
+            queue->vptr->enqueue_default(queue, &elements.at(i), sizeof(elements.at(i)));
+        }
+        while (!queue->vptr->is_empty(queue)) {
+            TestClass dequeued(0);
+            queue->vptr->dequeue_default(queue, &dequeued);
+            dequeues.push_back(dequeued);
+        }
+    }
+
+    ASSERT_EQ(dequeues, elements);
+}
+
+TEST(concurrent_fifo_buffer_try_dequeue_test, it_cannot_try_dequeue_from_empty_queue)
+{
+    auto const queue = reinterpret_cast<struct concurrent_fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), 14));
+
+    ASSERT_FALSE(queue->vptr->try_dequeue_default((struct fifo_buffer *)queue, nullptr));
+}
+
+TEST(concurrent_fifo_buffer_try_dequeue_test, it_dequeues_queued_element)
+{
+    auto const queue = reinterpret_cast<struct concurrent_fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), 14));
+
+    const TestClass element(128);
+    queue->vptr->enqueue((struct fifo_buffer *)queue, &element, sizeof(element), default_copy);
+
+    TestClass dequeued(0);
+    ASSERT_TRUE(queue->vptr->try_dequeue((struct fifo_buffer *)queue, &dequeued, default_copy));
+    ASSERT_EQ(dequeued, element);
+    ASSERT_TRUE(queue->vptr->is_empty((struct fifo_buffer *)queue));
+}
+
+TEST(concurrent_fifo_buffer_dequeue_bulk_test, it_dequeues_queued_elements_order_by_first_in_first_out)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    std::vector<TestClass> elements;
+    std::vector<TestClass> dequeues;
+    for (size_t i = 0; i < 65535; i++) {
+        elements.emplace_back(i);
+    }
+
+    size_t enqueued = 0;
+    while (dequeues.size() != elements.size()) {
+        enqueued += queue->vptr->enqueue_bulk(queue, elements.data() + enqueued, sizeof(TestClass), std::min<size_t>(elements.size() - enqueued, 5), default_copy);
+
+        std::vector<TestClass> buffer(3, TestClass(0));
+        const size_t dequeued = queue->vptr->dequeue_bulk(queue, buffer.data(), sizeof(TestClass), buffer.size(), default_copy);
+        dequeues.insert(dequeues.end(), buffer.begin(), buffer.begin() + dequeued);
+    }
+
+    ASSERT_EQ(dequeues, elements);
+}
+
+TEST(concurrent_fifo_buffer_dequeue_bulk_test, it_truncates_elements_larger_than_the_stride)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(2 * sizeof(uint64_t), 4));
+
+    const uint64_t element[2] = { 1, 2 };
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, sizeof(element)));
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, sizeof(element)));
+
+    uint64_t dequeues[3] = { 0, 0, UINT64_MAX };
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeues, sizeof(uint64_t), 2, memcpy), 2);
+    ASSERT_EQ(dequeues[0], 1);
+    ASSERT_EQ(dequeues[1], 1);
+    ASSERT_EQ(dequeues[2], UINT64_MAX);
+
+    queue->vptr->free(queue);
+}
+
+TEST(concurrent_fifo_buffer_count_test, it_returns_count_consistently_by_enqueueing_and_dequeueing_alternately)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), 0xFF));
+
+    const TestClass element(0);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    for (size_t i = 0; i < queue->vptr->capacity(queue); i++) {
+        const size_t count_full = queue->vptr->count(queue);
+        queue->vptr->dequeue_default(queue, nullptr);
+        ASSERT_EQ(queue->vptr->count(queue), count_full - 1);
+
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+        ASSERT_EQ(queue->vptr->count(queue), count_full);
+    }
+}
+
+TEST(concurrent_fifo_buffer_contensivity_test, it_never_contensive_when_single_reader_and_single_writer)
+{
+    constexpr std::size_t required_capacity = 2048;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    const size_t tail = 65536 * 16;
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        for (size_t i = 0; i < tail; i++) {
+            TestClass element(0);
+            while (!queue->vptr->dequeue_default(queue, &element)) {
+                // block until successfully dequeued
+            }
+            ASSERT_EQ(element.dummy(), i);
+        }
+    });
+    auto producer = std::async(std::launch::async, [queue] () {
+        for (size_t i = 0; i < tail; i++) {
+            TestClass element(i);
+            while (!queue->vptr->enqueue_default(queue, &element, sizeof(element))) {
+                // block until successfully enqueued
+            }
+        }
+    });
+
+    producer.wait();
+    consumer.wait();
+}
+
+TEST(concurrent_fifo_buffer_contensivity_test, it_delivers_every_element_exactly_once_when_multiple_readers_and_multiple_writers)
+{
+    constexpr std::size_t writers = 8;
+    constexpr std::size_t readers = 8;
+    constexpr std::size_t tail = 16384;
+    auto const queue = reinterpret_cast<struct concurrent_fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), 1024));
+
+    std::vector<std::atomic<size_t>> delivered(writers * tail);
+    std::atomic<size_t> remaining(writers * tail);
+
+    std::vector<std::future<void>> tasks;
+    for (size_t r = 0; r < readers; r++) {
+        tasks.push_back(std::async(std::launch::async, [queue, r, &delivered, &remaining] () {
+            // every reader must observe each writer's elements in increasing order
+            std::vector<size_t> last(writers, 0);
+            while (remaining.load() > 0) {
+                TestClass element(0);
+                const bool dequeued = r % 2 == 0
+                    ? queue->vptr->dequeue_default((fifo_buffer *)queue, &element)
+                    : queue->vptr->try_dequeue_default((fifo_buffer *)queue, &element);
+                if (!dequeued) {
+                    continue;
+                }
+                const size_t writer = element.dummy() / tail;
+                const size_t sequence = element.dummy() % tail + 1;
+                ASSERT_GT(sequence, last.at(writer));
+                last.at(writer) = sequence;
+                delivered.at(element.dummy()).fetch_add(1);
+                remaining.fetch_sub(1);
+            }
+        }));
+    }
+    for (size_t w = 0; w < writers; w++) {
+        tasks.push_back(std::async(std::launch::async, [queue, w] () {
+            for (size_t i = 0; i < tail; i++) {
+                const TestClass element(w * tail + i);
+                while (!queue->vptr->enqueue_default((fifo_buffer *)queue, &element, sizeof(element))) {
+                    // block until successfully enqueued
+                }
+            }
+        }));
+    }
+
+    for (auto &task: tasks) {
+        task.wait();
+    }
+
+    ASSERT_TRUE(std::all_of(delivered.begin(), delivered.end(), [] (const std::atomic<size_t> &count) { return count.load() == 1; }));
+    ASSERT_TRUE(queue->vptr->is_empty((fifo_buffer *)queue));
+}
+
+TEST(concurrent_fifo_buffer_contensivity_test, it_delivers_every_element_exactly_once_when_multiple_readers_and_multiple_writers_transfer_in_bulk)
+{
+    constexpr std::size_t writers = 4;
+    constexpr std::size_t readers = 4;
+    constexpr std::size_t batch = 16;
+    constexpr std::size_t tail = 16384;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(concurrent_fifo_buffer_new(sizeof(TestClass), 1024));
+
+    std::vector<std::atomic<size_t>> delivered(writers * tail);
+    std::atomic<size_t> remaining(writers * tail);
+
+    std::vector<std::future<void>> tasks;
+    for (size_t r = 0; r < readers; r++) {
+        tasks.push_back(std::async(std::launch::async, [queue, &delivered, &remaining] () {
+            std::vector<TestClass> elements(batch, TestClass(0));
+            while (remaining.load() > 0) {
+                const size_t dequeued = queue->vptr->dequeue_bulk(queue, elements.data(), sizeof(TestClass), batch, default_copy);
+                for (size_t i = 0; i < dequeued; i++) {
+                    delivered.at(elements.at(i).dummy()).fetch_add(1);
+                }
+                remaining.fetch_sub(dequeued);
+            }
+        }));
+    }
+    for (size_t w = 0; w < writers; w++) {
+        tasks.push_back(std::async(std::launch::async, [queue, w] () {
+            std::vector<TestClass> elements;
+            for (size_t i = 0; i < tail; i++) {
+                elements.emplace_back(w * tail + i);
+            }
+            for (size_t enqueued = 0; enqueued < tail;) {
+                enqueued += queue->vptr->enqueue_bulk(queue, elements.data() + enqueued, sizeof(TestClass), (tail - enqueued < batch ? tail - enqueued : batch), default_copy);
+            }
+        }));
+    }
+
+    for (auto &task: tasks) {
+        task.wait();
+    }
+
+    ASSERT_TRUE(std::all_of(delivered.begin(), delivered.end(), [] (const std::atomic<size_t> &count) { return count.load() == 1; }));
+}
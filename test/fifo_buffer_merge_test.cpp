@@ -0,0 +1,227 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "fifo_buffer_merge.h"
+#include "lockfree_fifo_buffer.h"
+}
+
+namespace {
+
+uint64_t timestamp_of(const void *element, size_t, void *)
+{
+    return *static_cast<const uint64_t *>(element);
+}
+
+std::vector<struct fifo_buffer *> make_inputs(size_t count, size_t capacity = 64)
+{
+    std::vector<struct fifo_buffer *> inputs;
+    for (size_t i = 0; i < count; i++) {
+        inputs.push_back(reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(uint64_t), capacity)));
+    }
+    return inputs;
+}
+
+void push(struct fifo_buffer *input, uint64_t timestamp)
+{
+    ASSERT_TRUE(input->vptr->enqueue_default(input, &timestamp, sizeof(timestamp)));
+}
+
+void free_inputs(const std::vector<struct fifo_buffer *> &inputs)
+{
+    for (auto const input: inputs) {
+        input->vptr->free(input);
+    }
+}
+
+} // namespace
+
+TEST(fifo_buffer_merge_test, it_merges_inputs_in_key_order)
+{
+    auto const inputs = make_inputs(3);
+    auto const merge = fifo_buffer_merge_new(inputs.data(), inputs.size(), timestamp_of, nullptr);
+    for (const uint64_t timestamp: { 1, 4, 7, 10 }) {
+        push(inputs.at(0), timestamp);
+    }
+    for (const uint64_t timestamp: { 2, 5, 8, 11 }) {
+        push(inputs.at(1), timestamp);
+    }
+    for (const uint64_t timestamp: { 3, 6, 9, 12 }) {
+        push(inputs.at(2), timestamp);
+    }
+
+    // the last element of each input waits until that input shows its next head
+    std::vector<uint64_t> merged(12);
+    ASSERT_EQ(fifo_buffer_merge_dequeue_bulk(merge, merged.data(), sizeof(uint64_t), merged.size(), memcpy), 10);
+    merged.resize(10);
+    ASSERT_EQ(merged, (std::vector<uint64_t> { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }));
+
+    fifo_buffer_merge_advance_watermark(merge, UINT64_MAX);
+    uint64_t element = 0;
+    ASSERT_TRUE(fifo_buffer_merge_dequeue_default(merge, &element));
+    ASSERT_EQ(element, 11);
+    ASSERT_TRUE(fifo_buffer_merge_dequeue_default(merge, &element));
+    ASSERT_EQ(element, 12);
+    ASSERT_FALSE(fifo_buffer_merge_dequeue_default(merge, &element));
+
+    fifo_buffer_merge_delete(merge);
+    free_inputs(inputs);
+}
+
+TEST(fifo_buffer_merge_test, it_waits_for_idle_inputs_until_the_watermark)
+{
+    auto const inputs = make_inputs(2);
+    auto const merge = fifo_buffer_merge_new(inputs.data(), inputs.size(), timestamp_of, nullptr);
+    push(inputs.at(0), 10);
+    push(inputs.at(0), 20);
+
+    ASSERT_EQ(fifo_buffer_merge_peek(merge, nullptr, nullptr), nullptr);
+
+    fifo_buffer_merge_advance_watermark(merge, 15);
+    size_t size = 0;
+    size_t input = SIZE_MAX;
+    const void *const head = fifo_buffer_merge_peek(merge, &size, &input);
+    ASSERT_NE(head, nullptr);
+    ASSERT_EQ(timestamp_of(head, size, nullptr), 10);
+    ASSERT_EQ(size, sizeof(uint64_t));
+    ASSERT_EQ(input, 0);
+
+    uint64_t element = 0;
+    ASSERT_TRUE(fifo_buffer_merge_dequeue_default(merge, &element));
+    ASSERT_EQ(element, 10);
+    ASSERT_FALSE(fifo_buffer_merge_dequeue_default(merge, &element));
+
+    // a head on the idle input makes the watermark unnecessary
+    push(inputs.at(1), 18);
+    ASSERT_TRUE(fifo_buffer_merge_dequeue_default(merge, &element));
+    ASSERT_EQ(element, 18);
+
+    fifo_buffer_merge_advance_watermark(merge, 5);
+    ASSERT_EQ(fifo_buffer_merge_watermark(merge), 15);
+
+    fifo_buffer_merge_delete(merge);
+    free_inputs(inputs);
+}
+
+TEST(fifo_buffer_merge_test, it_polls_idle_inputs_for_heads_queued_before_the_watermark_moved)
+{
+    auto const inputs = make_inputs(2);
+    auto const merge = fifo_buffer_merge_new(inputs.data(), inputs.size(), timestamp_of, nullptr);
+    fifo_buffer_merge_advance_watermark(merge, 100);
+    push(inputs.at(0), 100);
+    push(inputs.at(0), 150);
+
+    uint64_t element = 0;
+    ASSERT_TRUE(fifo_buffer_merge_dequeue_default(merge, &element));
+    ASSERT_EQ(element, 100);
+    ASSERT_FALSE(fifo_buffer_merge_dequeue_default(merge, &element));
+
+    // queued while the watermark was still 100, so it may be below the new one
+    push(inputs.at(1), 120);
+    fifo_buffer_merge_advance_watermark(merge, 200);
+    ASSERT_TRUE(fifo_buffer_merge_dequeue_default(merge, &element));
+    ASSERT_EQ(element, 120);
+
+    // below the watermark of the last poll, so input 0 cannot be preceded by anything new
+    push(inputs.at(0), 160);
+    push(inputs.at(1), 200);
+    for (const uint64_t expected: { 150, 160, 200 }) {
+        ASSERT_TRUE(fifo_buffer_merge_dequeue_default(merge, &element));
+        ASSERT_EQ(element, expected);
+    }
+
+    fifo_buffer_merge_delete(merge);
+    free_inputs(inputs);
+}
+
+TEST(fifo_buffer_merge_test, it_emits_equal_keys_by_input_order)
+{
+    auto const inputs = make_inputs(3);
+    auto const merge = fifo_buffer_merge_new(inputs.data(), inputs.size(), timestamp_of, nullptr);
+    push(inputs.at(2), 7);
+    push(inputs.at(0), 7);
+    push(inputs.at(1), 7);
+    fifo_buffer_merge_advance_watermark(merge, 7);
+
+    for (size_t expected = 0; expected < 3; expected++) {
+        size_t input = SIZE_MAX;
+        ASSERT_NE(fifo_buffer_merge_peek(merge, nullptr, &input), nullptr);
+        ASSERT_EQ(input, expected);
+        ASSERT_TRUE(fifo_buffer_merge_dequeue_default(merge, nullptr));
+    }
+
+    fifo_buffer_merge_delete(merge);
+    free_inputs(inputs);
+}
+
+TEST(fifo_buffer_merge_test, it_truncates_elements_larger_than_the_stride)
+{
+    std::vector<struct fifo_buffer *> inputs;
+    for (size_t i = 0; i < 2; i++) {
+        inputs.push_back(reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(2 * sizeof(uint64_t), 4)));
+    }
+    auto const merge = fifo_buffer_merge_new(inputs.data(), inputs.size(), timestamp_of, nullptr);
+    const uint64_t first[2] = { 1, UINT64_MAX - 1 };
+    const uint64_t second[2] = { 2, UINT64_MAX - 1 };
+    ASSERT_TRUE(inputs.at(0)->vptr->enqueue_default(inputs.at(0), first, sizeof(first)));
+    ASSERT_TRUE(inputs.at(1)->vptr->enqueue_default(inputs.at(1), second, sizeof(second)));
+    fifo_buffer_merge_advance_watermark(merge, UINT64_MAX);
+
+    uint64_t merged[3] = { 0, 0, UINT64_MAX };
+    ASSERT_EQ(fifo_buffer_merge_dequeue_bulk(merge, merged, sizeof(uint64_t), 2, memcpy), 2);
+    ASSERT_EQ(merged[0], 1);
+    ASSERT_EQ(merged[1], 2);
+    ASSERT_EQ(merged[2], UINT64_MAX);
+
+    fifo_buffer_merge_delete(merge);
+    free_inputs(inputs);
+}
+
+TEST(fifo_buffer_merge_test, it_merges_concurrent_producers_in_order)
+{
+    constexpr size_t producers = 4;
+    constexpr uint64_t per_producer = 20000;
+    auto const inputs = make_inputs(producers, 16);
+    auto const merge = fifo_buffer_merge_new(inputs.data(), inputs.size(), timestamp_of, nullptr);
+
+    // producer p emits p, p + producers, p + 2 * producers, ...
+    std::vector<std::future<void>> tasks;
+    for (size_t producer = 0; producer < producers; producer++) {
+        tasks.push_back(std::async(std::launch::async, [&inputs, producer] () {
+            for (uint64_t i = 0; i < per_producer; i++) {
+                const uint64_t timestamp = i * producers + producer;
+                while (!inputs.at(producer)->vptr->enqueue_default(inputs.at(producer), &timestamp, sizeof(timestamp))) {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    uint64_t expected = 0;
+    while (expected < producers * per_producer) {
+        // every producer is done with everything below what all of them have passed
+        if (expected + producers >= producers * per_producer) {
+            for (auto &task: tasks) {
+                task.wait();
+            }
+            fifo_buffer_merge_advance_watermark(merge, UINT64_MAX);
+        }
+
+        uint64_t element = 0;
+        if (!fifo_buffer_merge_dequeue_default(merge, &element)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(element, expected);
+        expected++;
+    }
+
+    fifo_buffer_merge_delete(merge);
+    free_inputs(inputs);
+}
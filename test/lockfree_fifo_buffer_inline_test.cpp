@@ -0,0 +1,115 @@
+#include <memory>
+#include <future>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "lockfree_fifo_buffer.h"
+
+bool inline_enqueue(struct fifo_buffer *self, const void *element, size_t size);
+bool inline_dequeue(struct fifo_buffer *self, void *element);
+const void *inline_peek(struct fifo_buffer *self, size_t *size);
+}
+
+TEST(lockfree_fifo_buffer_inline_test, it_enqueues_until_full)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(size_t), 14));
+
+    size_t enqueued = 0;
+    while (inline_enqueue(queue, &enqueued, sizeof(enqueued))) {
+        enqueued++;
+    }
+
+    ASSERT_EQ(enqueued, queue->vptr->count(queue));
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_inline_test, it_cannot_dequeue_from_empty_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(size_t), 14));
+
+    size_t element = 0;
+    ASSERT_FALSE(inline_dequeue(queue, &element));
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_inline_test, it_dequeues_elements_order_by_first_in_first_out)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(size_t), 14));
+
+    for (size_t round = 0; round < 4; round++) {
+        for (size_t i = 0; i < 10; i++) {
+            ASSERT_TRUE(inline_enqueue(queue, &i, sizeof(i)));
+        }
+        for (size_t i = 0; i < 10; i++) {
+            size_t element = SIZE_MAX;
+            ASSERT_TRUE(inline_dequeue(queue, &element));
+            ASSERT_EQ(element, i);
+        }
+    }
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_inline_test, it_interoperates_with_vtable_operations)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(size_t), 14));
+
+    for (size_t i = 0; i < 64; i++) {
+        size_t element = SIZE_MAX;
+        if (i % 2 == 0) {
+            ASSERT_TRUE(inline_enqueue(queue, &i, sizeof(i)));
+            ASSERT_TRUE(queue->vptr->dequeue_default(queue, &element));
+        } else {
+            ASSERT_TRUE(queue->vptr->enqueue_default(queue, &i, sizeof(i)));
+            ASSERT_TRUE(inline_dequeue(queue, &element));
+        }
+        ASSERT_EQ(element, i);
+    }
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_inline_test, it_peeks_head_element_without_dequeueing)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(size_t), 14));
+
+    size_t size = 0;
+    ASSERT_EQ(inline_peek(queue, &size), nullptr);
+
+    const size_t first = 42;
+    const size_t second = 43;
+    ASSERT_TRUE(inline_enqueue(queue, &first, sizeof(first)));
+    ASSERT_TRUE(inline_enqueue(queue, &second, sizeof(second)));
+
+    auto const head = static_cast<const size_t *>(inline_peek(queue, &size));
+    ASSERT_NE(head, nullptr);
+    ASSERT_EQ(*head, first);
+    ASSERT_EQ(size, sizeof(first));
+    ASSERT_EQ(queue->vptr->count(queue), 2);
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_inline_test, it_never_contensive_when_single_reader_and_single_writer)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(size_t), 63));
+    constexpr size_t total = 100000;
+
+    auto writer = std::async(std::launch::async, [queue] () {
+        for (size_t i = 0; i < total; i++) {
+            while (!inline_enqueue(queue, &i, sizeof(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (size_t i = 0; i < total; i++) {
+        size_t element = SIZE_MAX;
+        while (!inline_dequeue(queue, &element)) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(element, i);
+    }
+    writer.wait();
+    queue->vptr->free(queue);
+}
@@ -0,0 +1,18 @@
+// lockfree_fifo_buffer_inline.h needs C11 atomics, so the tests reach it through here.
+
+#include "lockfree_fifo_buffer_inline.h"
+
+bool inline_enqueue(struct fifo_buffer *const self, const void *const element, const size_t size)
+{
+    return lockfree_fifo_buffer_enqueue_inline((struct lockfree_fifo_buffer *)self, element, size);
+}
+
+bool inline_dequeue(struct fifo_buffer *const self, void *const element)
+{
+    return lockfree_fifo_buffer_dequeue_inline((struct lockfree_fifo_buffer *)self, element);
+}
+
+const void *inline_peek(struct fifo_buffer *const self, size_t *const size)
+{
+    return lockfree_fifo_buffer_peek_inline((struct lockfree_fifo_buffer *)self, size);
+}
@@ -1,9 +1,18 @@
 #include <memory>
 #include <future>
+#include <new>
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
+#include <time.h>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
 extern "C" {
+#include "fifo_buffer_stats.h"
 #include "lockfree_fifo_buffer.h"
 }
 
@@ -48,6 +57,30 @@ TEST(lockfree_fifo_buffer_initialize_test, it_has_enough_capacity)
     }
 }
 
+TEST(lockfree_fifo_buffer_initialize_test, it_honors_power_of_two_capacity_and_uses_every_slot)
+{
+    for (const size_t requested: { 1, 2, 1024 }) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(size_t), requested));
+        ASSERT_EQ(queue->vptr->capacity(queue), requested);
+
+        for (size_t round = 0; round < 3; round++) {
+            for (size_t i = 0; i < requested; i++) {
+                ASSERT_TRUE(queue->vptr->enqueue_default(queue, &i, sizeof(i)));
+            }
+            ASSERT_TRUE(queue->vptr->is_full(queue));
+            ASSERT_EQ(queue->vptr->count(queue), requested);
+            ASSERT_FALSE(queue->vptr->enqueue_default(queue, &round, sizeof(round)));
+
+            for (size_t i = 0; i < requested; i++) {
+                size_t element = SIZE_MAX;
+                ASSERT_TRUE(queue->vptr->dequeue_default(queue, &element));
+                ASSERT_EQ(element, i);
+            }
+        }
+        queue->vptr->free(queue);
+    }
+}
+
 TEST(lockfree_fifo_buffer_initialize_test, it_is_empty_after_initialization)
 {
     for (size_t i = 0; i < 128; i++) {
@@ -58,6 +91,27 @@ TEST(lockfree_fifo_buffer_initialize_test, it_is_empty_after_initialization)
     }
 }
 
+TEST(lockfree_fifo_buffer_initialize_test, it_aligns_every_element_for_any_type)
+{
+    for (size_t element_size = 1; element_size < 64; element_size += 3) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(element_size, 14));
+
+        const std::vector<uint8_t> element(element_size, 0xA5);
+        while (!queue->vptr->is_full(queue)) {
+            queue->vptr->enqueue_default(queue, element.data(), element.size());
+        }
+        while (!queue->vptr->is_empty(queue)) {
+            const auto address = reinterpret_cast<std::uintptr_t>(queue->vptr->peek(queue));
+            ASSERT_EQ(address % alignof(std::max_align_t), 0);
+
+            std::vector<uint8_t> dequeued(element_size, 0);
+            queue->vptr->dequeue_default(queue, dequeued.data());
+            ASSERT_EQ(dequeued, element);
+        }
+        queue->vptr->free(queue);
+    }
+}
+
 TEST(lockfree_fifo_buffer_enqueue_default_test, it_enqueues_an_element)
 {
     auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
@@ -290,6 +344,246 @@ TEST(lockfree_fifo_buffer_dequeue_test, it_dequeues_queued_elements_order_by_fir
     ASSERT_EQ(dequeues, elements);
 }
 
+TEST(lockfree_fifo_buffer_enqueue_bulk_test, it_enqueues_all_elements_when_enough_space)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    std::vector<TestClass> elements;
+    for (size_t i = 0; i < required_capacity; i++) {
+        elements.emplace_back(i);
+    }
+
+    ASSERT_EQ(queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy), elements.size());
+    ASSERT_EQ(queue->vptr->count(queue), elements.size());
+}
+
+TEST(lockfree_fifo_buffer_enqueue_bulk_test, it_enqueues_elements_only_into_free_slots)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    std::vector<TestClass> elements;
+    for (size_t i = 0; i < queue->vptr->capacity(queue) * 2; i++) {
+        elements.emplace_back(i);
+    }
+
+    const size_t enqueued = queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy);
+    ASSERT_LT(enqueued, elements.size());
+    ASSERT_EQ(queue->vptr->count(queue), enqueued);
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+    ASSERT_EQ(queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy), 0);
+}
+
+TEST(lockfree_fifo_buffer_dequeue_bulk_test, it_cannot_dequeue_from_empty_queue)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    std::vector<TestClass> dequeues(4, TestClass(0));
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeues.data(), sizeof(TestClass), dequeues.size(), default_copy), 0);
+}
+
+TEST(lockfree_fifo_buffer_dequeue_bulk_test, it_dequeues_at_most_queued_elements)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    const TestClass element(128);
+    for (size_t i = 0; i < 3; i++) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    std::vector<TestClass> dequeues(8, TestClass(0));
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeues.data(), sizeof(TestClass), dequeues.size(), default_copy), 3);
+    ASSERT_EQ(dequeues.at(2), element);
+    ASSERT_EQ(dequeues.at(3), TestClass(0));
+    ASSERT_TRUE(queue->vptr->is_empty(queue));
+}
+
+TEST(lockfree_fifo_buffer_dequeue_bulk_test, it_truncates_elements_larger_than_the_stride)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(2 * sizeof(uint64_t), 4));
+
+    const uint64_t element[2] = { 1, 2 };
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, sizeof(element)));
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, sizeof(element)));
+
+    uint64_t dequeues[3] = { 0, 0, UINT64_MAX };
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeues, sizeof(uint64_t), 2, memcpy), 2);
+    ASSERT_EQ(dequeues[0], 1);
+    ASSERT_EQ(dequeues[1], 1);
+    ASSERT_EQ(dequeues[2], UINT64_MAX);
+
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_dequeue_bulk_test, it_dequeues_queued_elements_order_by_first_in_first_out)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    std::vector<TestClass> elements;
+    std::vector<TestClass> dequeues;
+    for (size_t i = 0; i < 65535; i++) {
+        elements.emplace_back(i);
+    }
+
+    size_t enqueued = 0;
+    while (enqueued != elements.size()) {
+        enqueued += queue->vptr->enqueue_bulk(queue, &elements.at(enqueued), sizeof(TestClass), std::min<size_t>(elements.size() - enqueued, 5), default_copy);
+
+        std::vector<TestClass> buffer(3, TestClass(0));
+        const size_t dequeued = queue->vptr->dequeue_bulk(queue, buffer.data(), sizeof(TestClass), buffer.size(), default_copy);
+        dequeues.insert(dequeues.end(), buffer.begin(), buffer.begin() + dequeued);
+    }
+    while (!queue->vptr->is_empty(queue)) {
+        TestClass dequeued(0);
+        queue->vptr->dequeue_bulk(queue, &dequeued, sizeof(TestClass), 1, default_copy);
+        dequeues.push_back(dequeued);
+    }
+
+    ASSERT_EQ(dequeues, elements);
+}
+
+TEST(lockfree_fifo_buffer_reserve_test, it_reserves_a_slot_without_enqueueing)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    void *const slot = lockfree_fifo_buffer_reserve(queue);
+
+    ASSERT_NE(slot, nullptr);
+    ASSERT_EQ(lockfree_fifo_buffer_reserve(queue), slot);
+    ASSERT_TRUE(queue->vptr->is_empty(queue));
+}
+
+TEST(lockfree_fifo_buffer_reserve_test, it_cannot_reserve_from_full_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    const TestClass element(128);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    ASSERT_EQ(lockfree_fifo_buffer_reserve(queue), nullptr);
+}
+
+TEST(lockfree_fifo_buffer_commit_test, it_publishes_element_written_into_reserved_slot)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    new (lockfree_fifo_buffer_reserve(queue)) TestClass(128);
+    lockfree_fifo_buffer_commit(queue, sizeof(TestClass));
+
+    ASSERT_EQ(queue->vptr->count(queue), 1);
+    ASSERT_EQ(queue->vptr->peek_size(queue), sizeof(TestClass));
+
+    TestClass dequeued(0);
+    queue->vptr->dequeue_default(queue, &dequeued);
+    ASSERT_EQ(dequeued, TestClass(128));
+}
+
+TEST(lockfree_fifo_buffer_commit_test, it_dequeues_committed_elements_order_by_first_in_first_out)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    for (size_t i = 0; i < 65535; i++) {
+        void *const slot = lockfree_fifo_buffer_reserve(queue);
+        ASSERT_NE(slot, nullptr);
+        new (slot) TestClass(i);
+        lockfree_fifo_buffer_commit(queue, sizeof(TestClass));
+
+        TestClass dequeued(0);
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &dequeued));
+        ASSERT_EQ(dequeued.dummy(), i);
+    }
+}
+
+TEST(lockfree_fifo_buffer_acquire_test, it_cannot_acquire_from_empty_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    size_t size = 0;
+    ASSERT_EQ(lockfree_fifo_buffer_acquire(queue, &size), nullptr);
+}
+
+TEST(lockfree_fifo_buffer_acquire_test, it_acquires_head_element_without_dequeueing)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    const TestClass element(128);
+    queue->vptr->enqueue_default(queue, &element, sizeof(element));
+
+    size_t size = 0;
+    const auto *const acquired = reinterpret_cast<const TestClass *>(lockfree_fifo_buffer_acquire(queue, &size));
+
+    ASSERT_EQ(*acquired, element);
+    ASSERT_EQ(size, sizeof(element));
+    ASSERT_EQ(queue->vptr->count(queue), 1);
+}
+
+TEST(lockfree_fifo_buffer_acquire_test, it_acquires_at_most_queued_elements)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    for (size_t i = 0; i < 3; i++) {
+        const TestClass element(i);
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    std::vector<const void *> acquired(8, nullptr);
+    std::vector<size_t> sizes(8, 0);
+    ASSERT_EQ(lockfree_fifo_buffer_acquire_n(queue, acquired.data(), sizes.data(), acquired.size()), 3);
+    for (size_t i = 0; i < 3; i++) {
+        ASSERT_EQ(reinterpret_cast<const TestClass *>(acquired.at(i))->dummy(), i);
+        ASSERT_EQ(sizes.at(i), sizeof(TestClass));
+    }
+}
+
+TEST(lockfree_fifo_buffer_release_test, it_releases_acquired_elements)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    const TestClass element(128);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+    const size_t count = queue->vptr->count(queue);
+
+    std::vector<const void *> acquired(4, nullptr);
+    const size_t n = lockfree_fifo_buffer_acquire_n(queue, acquired.data(), nullptr, acquired.size());
+    lockfree_fifo_buffer_release(queue, n);
+
+    ASSERT_EQ(queue->vptr->count(queue), count - n);
+    ASSERT_FALSE(queue->vptr->is_full(queue));
+}
+
+TEST(lockfree_fifo_buffer_release_test, it_acquires_elements_order_by_first_in_first_out)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    std::vector<TestClass> elements;
+    std::vector<TestClass> dequeues;
+    for (size_t i = 0; i < 65535; i++) {
+        elements.emplace_back(i);
+    }
+
+    size_t enqueued = 0;
+    std::vector<const void *> acquired(5, nullptr);
+    while (dequeues.size() != elements.size()) {
+        enqueued += queue->vptr->enqueue_bulk(queue, elements.data() + enqueued, sizeof(TestClass), std::min<size_t>(elements.size() - enqueued, 7), default_copy);
+
+        const size_t n = lockfree_fifo_buffer_acquire_n(queue, acquired.data(), nullptr, acquired.size());
+        for (size_t i = 0; i < n; i++) {
+            dequeues.push_back(*reinterpret_cast<const TestClass *>(acquired.at(i)));
+        }
+        lockfree_fifo_buffer_release(queue, n);
+    }
+
+    ASSERT_EQ(dequeues, elements);
+}
+
 TEST(lockfree_fifo_buffer_peek_test, it_cannot_peak_from_empty_queue)
 {
     constexpr std::size_t required_capacity = 14;
@@ -411,6 +705,298 @@ TEST(lockfree_fifo_buffer_count_test, it_returns_count_consistently_by_enqueuein
     }
 }
 
+// node backing the page at address, or -1 when the kernel cannot tell
+static int node_of(const void *address)
+{
+    constexpr int mpol_f_node = 1;
+    constexpr int mpol_f_addr = 2;
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address, mpol_f_node | mpol_f_addr) != 0) {
+        return -1;
+    }
+    return node;
+}
+
+TEST(lockfree_fifo_buffer_numa_test, it_leaves_storage_to_first_touch_by_default)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    ASSERT_EQ(lockfree_fifo_buffer_numa_node(queue), -1);
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_numa_test, it_binds_storage_to_given_node)
+{
+    const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_NODE, 0 };
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new_with_options(sizeof(size_t), 1023, &options));
+    ASSERT_NE(queue, nullptr);
+    ASSERT_EQ(lockfree_fifo_buffer_numa_node(queue), 0);
+
+    for (size_t i = 0; i < 1023; i++) {
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, &i, sizeof(i)));
+    }
+    const int node = node_of(queue->vptr->peek(queue));
+    if (node >= 0) {
+        ASSERT_EQ(node, 0);
+        ASSERT_EQ(node_of(queue), 0);
+    }
+    for (size_t i = 0; i < 1023; i++) {
+        size_t element = SIZE_MAX;
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &element));
+        ASSERT_EQ(element, i);
+    }
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_numa_test, it_binds_storage_to_node_of_creating_thread)
+{
+    const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_CURRENT_NODE, 0 };
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new_with_options(sizeof(TestClass), 14, &options));
+    ASSERT_NE(queue, nullptr);
+    ASSERT_GE(lockfree_fifo_buffer_numa_node(queue), 0);
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_numa_test, it_binds_storage_of_caller_placed_buffer)
+{
+    const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_NODE, 0 };
+    auto const memory = std::make_unique<std::aligned_storage_t<4096, 64>>();
+    auto const queue = reinterpret_cast<struct lockfree_fifo_buffer *>(memory.get());
+    ASSERT_TRUE(lockfree_fifo_buffer_initialize_with_options(queue, sizeof(TestClass), 14, &options));
+
+    auto const base = reinterpret_cast<struct fifo_buffer *>(queue);
+    ASSERT_EQ(lockfree_fifo_buffer_numa_node(base), 0);
+    base->vptr->dispose(base);
+}
+
+TEST(lockfree_fifo_buffer_numa_test, it_fails_for_nodes_that_do_not_exist)
+{
+    for (const int node: { -1, 1023, 4096 }) {
+        const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_NODE, node };
+        ASSERT_EQ(lockfree_fifo_buffer_new_with_options(sizeof(TestClass), 14, &options), nullptr);
+    }
+}
+
+TEST(lockfree_fifo_buffer_pages_test, it_uses_small_pages_by_default)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    ASSERT_EQ(lockfree_fifo_buffer_page_backing(queue), FIFO_BUFFER_PAGES_SMALL);
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_pages_test, it_falls_back_to_pages_the_system_can_give)
+{
+    for (const auto pages: { FIFO_BUFFER_PAGES_TRANSPARENT_HUGE, FIFO_BUFFER_PAGES_HUGETLB }) {
+        const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_FIRST_TOUCH, 0, pages };
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new_with_options(sizeof(size_t), 65535, &options));
+        ASSERT_NE(queue, nullptr);
+
+        const auto backing = lockfree_fifo_buffer_page_backing(queue);
+        ASSERT_LE(backing, pages);
+
+        for (size_t i = 0; i < 65535; i++) {
+            ASSERT_TRUE(queue->vptr->enqueue_default(queue, &i, sizeof(i)));
+        }
+        for (size_t i = 0; i < 65535; i++) {
+            size_t element = SIZE_MAX;
+            ASSERT_TRUE(queue->vptr->dequeue_default(queue, &element));
+            ASSERT_EQ(element, i);
+        }
+        queue->vptr->free(queue);
+    }
+}
+
+TEST(lockfree_fifo_buffer_pages_test, it_binds_huge_page_storage_to_given_node)
+{
+    const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_NODE, 0, FIFO_BUFFER_PAGES_TRANSPARENT_HUGE };
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new_with_options(sizeof(size_t), 1023, &options));
+    ASSERT_NE(queue, nullptr);
+    ASSERT_EQ(lockfree_fifo_buffer_numa_node(queue), 0);
+
+    const size_t element = 42;
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+    const int node = node_of(queue->vptr->peek(queue));
+    if (node >= 0) {
+        ASSERT_EQ(node, 0);
+    }
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_pages_test, it_releases_huge_page_storage_of_caller_placed_buffer)
+{
+    const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_FIRST_TOUCH, 0, FIFO_BUFFER_PAGES_HUGETLB };
+    auto const memory = std::make_unique<std::aligned_storage_t<4096, 64>>();
+    auto const queue = reinterpret_cast<struct lockfree_fifo_buffer *>(memory.get());
+
+    for (size_t round = 0; round < 16; round++) {
+        ASSERT_TRUE(lockfree_fifo_buffer_initialize_with_options(queue, sizeof(TestClass), 14, &options));
+        auto const base = reinterpret_cast<struct fifo_buffer *>(queue);
+        base->vptr->dispose(base);
+    }
+}
+
+#if defined(FIFO_BUFFER_STATS)
+TEST(lockfree_fifo_buffer_stats_test, it_counts_transfers_rejects_and_polls)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    const TestClass element(128);
+    uint64_t enqueued = 0;
+    while (queue->vptr->enqueue_default(queue, &element, sizeof(element))) {
+        enqueued++;
+    }
+    while (queue->vptr->dequeue_default(queue, nullptr)) {
+        // do nothing
+    }
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(queue->vptr->stats_snapshot(queue, &stats));
+    EXPECT_EQ(stats.enqueued, enqueued);
+    EXPECT_EQ(stats.dequeued, enqueued);
+    EXPECT_EQ(stats.full_rejects, 1);
+    EXPECT_EQ(stats.empty_polls, 1);
+    EXPECT_EQ(stats.high_water_mark, enqueued);
+}
+
+TEST(lockfree_fifo_buffer_stats_test, it_keeps_a_low_high_water_mark_when_the_consumer_keeps_up)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 1024));
+
+    const TestClass element(128);
+    for (size_t i = 0; i < 2000; i++) {
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, nullptr));
+    }
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(queue->vptr->stats_snapshot(queue, &stats));
+    EXPECT_EQ(stats.enqueued, 2000);
+    EXPECT_EQ(stats.high_water_mark, 1);
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_stats_test, it_reports_page_backing_obtained)
+{
+    const struct lockfree_fifo_buffer_options options = { LOCKFREE_FIFO_BUFFER_NUMA_FIRST_TOUCH, 0, FIFO_BUFFER_PAGES_HUGETLB };
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new_with_options(sizeof(TestClass), 14, &options));
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(queue->vptr->stats_snapshot(queue, &stats));
+    EXPECT_EQ(stats.page_backing, lockfree_fifo_buffer_page_backing(queue));
+    queue->vptr->free(queue);
+}
+
+TEST(lockfree_fifo_buffer_stats_test, it_buckets_message_sizes_by_bit_width)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(64, 14));
+
+    const uint8_t element[64] {};
+    for (const size_t size: { 0, 1, 3, 64 }) {
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, size));
+    }
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(queue->vptr->stats_snapshot(queue, &stats));
+    EXPECT_EQ(stats.size_histogram[0], 1);
+    EXPECT_EQ(stats.size_histogram[1], 1);
+    EXPECT_EQ(stats.size_histogram[2], 1);
+    EXPECT_EQ(stats.size_histogram[7], 1);
+}
+#else
+TEST(lockfree_fifo_buffer_stats_test, it_has_no_stats_when_compiled_out)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_FALSE(queue->vptr->stats_snapshot(queue, &stats));
+}
+#endif
+
+static struct timespec deadline_after(std::chrono::nanoseconds timeout)
+{
+    struct timespec now {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const auto deadline = std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec) + timeout;
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(deadline);
+    return { static_cast<time_t>(seconds.count()), static_cast<long>((deadline - seconds).count()) };
+}
+
+TEST(lockfree_fifo_buffer_wait_test, it_times_out_dequeueing_from_empty_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto deadline = deadline_after(std::chrono::milliseconds(20));
+    TestClass element(0);
+
+    ASSERT_FALSE(lockfree_fifo_buffer_dequeue_until(queue, &element, default_copy, &deadline));
+    ASSERT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(20));
+}
+
+TEST(lockfree_fifo_buffer_wait_test, it_times_out_enqueueing_into_full_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    const TestClass element(128);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    const auto deadline = deadline_after(std::chrono::milliseconds(20));
+    ASSERT_FALSE(lockfree_fifo_buffer_enqueue_until(queue, &element, sizeof(element), default_copy, &deadline));
+}
+
+TEST(lockfree_fifo_buffer_wait_test, it_wakes_up_waiting_consumer_when_enqueued)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+    lockfree_fifo_buffer_set_spin_budget(queue, 0);
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        TestClass element(0);
+        EXPECT_TRUE(lockfree_fifo_buffer_dequeue_wait(queue, &element, default_copy));
+        return element;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    const TestClass element(128);
+    queue->vptr->enqueue_default(queue, &element, sizeof(element));
+
+    ASSERT_EQ(consumer.get(), element);
+}
+
+TEST(lockfree_fifo_buffer_wait_test, it_unblocks_waiting_consumer_when_closed)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+    lockfree_fifo_buffer_set_spin_budget(queue, 0);
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        TestClass element(0);
+        return lockfree_fifo_buffer_dequeue_wait(queue, &element, default_copy);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lockfree_fifo_buffer_close(queue);
+
+    ASSERT_FALSE(consumer.get());
+    ASSERT_TRUE(lockfree_fifo_buffer_is_closed(queue));
+}
+
+TEST(lockfree_fifo_buffer_wait_test, it_drains_queued_elements_but_rejects_new_ones_after_closed)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), 14));
+
+    const TestClass element(128);
+    queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    lockfree_fifo_buffer_close(queue);
+
+    ASSERT_FALSE(lockfree_fifo_buffer_enqueue_wait(queue, &element, sizeof(element), default_copy));
+
+    TestClass dequeued(0);
+    ASSERT_TRUE(lockfree_fifo_buffer_dequeue_wait(queue, &dequeued, default_copy));
+    ASSERT_EQ(dequeued, element);
+    ASSERT_FALSE(lockfree_fifo_buffer_dequeue_wait(queue, &dequeued, default_copy));
+}
+
 TEST(lockfree_fifo_buffer_contensivity_test, it_never_contensive_when_single_reader_and_single_writer)
 {
     constexpr std::size_t required_capacity = 2048;
@@ -439,3 +1025,62 @@ TEST(lockfree_fifo_buffer_contensivity_test, it_never_contensive_when_single_rea
     producer.wait();
     consumer.wait();
 }
+
+TEST(lockfree_fifo_buffer_contensivity_test, it_never_contensive_when_single_reader_and_single_writer_transfer_in_bulk)
+{
+    constexpr std::size_t required_capacity = 2048;
+    constexpr std::size_t batch = 100;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    constexpr std::size_t tail = 65536 * 16;
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        std::vector<TestClass> elements(batch, TestClass(0));
+        for (size_t i = 0; i < tail;) {
+            const size_t dequeued = queue->vptr->dequeue_bulk(queue, elements.data(), sizeof(TestClass), batch, default_copy);
+            for (size_t j = 0; j < dequeued; j++) {
+                ASSERT_EQ(elements.at(j).dummy(), i + j);
+            }
+            i += dequeued;
+        }
+    });
+    auto producer = std::async(std::launch::async, [queue] () {
+        std::vector<TestClass> elements;
+        for (size_t i = 0; i < tail;) {
+            elements.clear();
+            for (size_t j = i; j < i + batch && j < tail; j++) {
+                elements.emplace_back(j);
+            }
+            i += queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy);
+        }
+    });
+
+    producer.wait();
+    consumer.wait();
+}
+
+TEST(lockfree_fifo_buffer_contensivity_test, it_never_loses_wakeups_when_single_reader_and_single_writer_block)
+{
+    constexpr std::size_t required_capacity = 16;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lockfree_fifo_buffer_new(sizeof(TestClass), required_capacity));
+    lockfree_fifo_buffer_set_spin_budget(queue, 0);
+
+    constexpr std::size_t tail = 65536;
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        for (size_t i = 0; i < tail; i++) {
+            TestClass element(0);
+            ASSERT_TRUE(lockfree_fifo_buffer_dequeue_wait(queue, &element, default_copy));
+            ASSERT_EQ(element.dummy(), i);
+        }
+    });
+    auto producer = std::async(std::launch::async, [queue] () {
+        for (size_t i = 0; i < tail; i++) {
+            TestClass element(i);
+            ASSERT_TRUE(lockfree_fifo_buffer_enqueue_wait(queue, &element, sizeof(element), default_copy));
+        }
+    });
+
+    producer.wait();
+    consumer.wait();
+}
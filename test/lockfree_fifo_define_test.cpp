@@ -0,0 +1,105 @@
+#include <memory>
+#include <future>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "lockfree_fifo_define_test_helper.h"
+}
+
+TEST(lockfree_fifo_define_test, it_is_empty_after_initialization)
+{
+    auto const queue = point_fifo_new();
+
+    ASSERT_TRUE(point_fifo_empty(queue));
+    ASSERT_EQ(point_fifo_size(queue), 0);
+    ASSERT_EQ(point_fifo_front(queue), nullptr);
+    point_fifo_delete(queue);
+}
+
+TEST(lockfree_fifo_define_test, it_enqueues_until_full)
+{
+    auto const queue = point_fifo_new();
+
+    const struct point element { 1, 2.0 };
+    size_t pushed = 0;
+    while (point_fifo_push(queue, &element)) {
+        pushed++;
+    }
+
+    ASSERT_EQ(pushed, point_fifo_max_size());
+    ASSERT_TRUE(point_fifo_full(queue));
+    point_fifo_delete(queue);
+}
+
+TEST(lockfree_fifo_define_test, it_dequeues_elements_order_by_first_in_first_out)
+{
+    auto const queue = point_fifo_new();
+
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 10; i++) {
+            const struct point element { i, i * 0.5 };
+            ASSERT_TRUE(point_fifo_push(queue, &element));
+        }
+        for (int i = 0; i < 10; i++) {
+            struct point element {};
+            ASSERT_TRUE(point_fifo_pop(queue, &element));
+            ASSERT_EQ(element.x, i);
+            ASSERT_EQ(element.y, i * 0.5);
+        }
+    }
+    ASSERT_FALSE(point_fifo_pop(queue, nullptr));
+    point_fifo_delete(queue);
+}
+
+TEST(lockfree_fifo_define_test, it_peeks_head_element_without_dequeueing)
+{
+    auto const queue = point_fifo_new();
+
+    const struct point first { 1, 1.0 };
+    const struct point second { 2, 2.0 };
+    ASSERT_TRUE(point_fifo_push(queue, &first));
+    ASSERT_TRUE(point_fifo_push(queue, &second));
+
+    ASSERT_NE(point_fifo_front(queue), nullptr);
+    ASSERT_EQ(point_fifo_front(queue)->x, first.x);
+    ASSERT_EQ(point_fifo_size(queue), 2);
+    point_fifo_delete(queue);
+}
+
+TEST(lockfree_fifo_define_test, it_holds_one_element_in_smallest_queue)
+{
+    const unsigned char input[] = { 1, 2, 3, 4, 5 };
+    unsigned char output[sizeof(input)] = {};
+
+    ASSERT_EQ(byte_fifo_transfer(input, output, sizeof(input)), sizeof(input));
+    for (size_t i = 0; i < sizeof(input); i++) {
+        ASSERT_EQ(output[i], input[i]);
+    }
+}
+
+TEST(lockfree_fifo_define_test, it_never_contensive_when_single_reader_and_single_writer)
+{
+    auto const queue = point_fifo_new();
+    constexpr int total = 100000;
+
+    auto writer = std::async(std::launch::async, [queue] () {
+        for (int i = 0; i < total; i++) {
+            const struct point element { i, 0.0 };
+            while (!point_fifo_push(queue, &element)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (int i = 0; i < total; i++) {
+        struct point element {};
+        while (!point_fifo_pop(queue, &element)) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(element.x, i);
+    }
+    writer.wait();
+    point_fifo_delete(queue);
+}
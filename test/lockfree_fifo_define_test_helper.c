@@ -0,0 +1,77 @@
+// lockfree_fifo_define.h generates C11 code, so the tests reach the generated queues through here.
+
+#include <stdalign.h>
+#include <stdlib.h>
+
+#include "lockfree_fifo_define.h"
+#include "lockfree_fifo_define_test_helper.h"
+
+DEFINE_LOCKFREE_FIFO(point_fifo, struct point, 16)
+DEFINE_LOCKFREE_FIFO(byte_fifo, unsigned char, 1)
+
+struct point_fifo *point_fifo_new(void)
+{
+    struct point_fifo *const self = aligned_alloc(alignof(struct point_fifo), sizeof(struct point_fifo));
+    if (self != NULL) {
+        point_fifo_initialize(self);
+    }
+    return self;
+}
+
+void point_fifo_delete(struct point_fifo *const self)
+{
+    free(self);
+}
+
+bool point_fifo_push(struct point_fifo *const self, const struct point *const element)
+{
+    return point_fifo_enqueue(self, element);
+}
+
+bool point_fifo_pop(struct point_fifo *const self, struct point *const element)
+{
+    return point_fifo_dequeue(self, element);
+}
+
+const struct point *point_fifo_front(struct point_fifo *const self)
+{
+    return point_fifo_peek(self);
+}
+
+size_t point_fifo_size(const struct point_fifo *const self)
+{
+    return point_fifo_count(self);
+}
+
+size_t point_fifo_max_size(void)
+{
+    return point_fifo_capacity();
+}
+
+bool point_fifo_full(const struct point_fifo *const self)
+{
+    return point_fifo_is_full(self);
+}
+
+bool point_fifo_empty(const struct point_fifo *const self)
+{
+    return point_fifo_is_empty(self);
+}
+
+size_t byte_fifo_transfer(const unsigned char *const input, unsigned char *const output, const size_t count)
+{
+    struct byte_fifo queue;
+    byte_fifo_initialize(&queue);
+
+    size_t transferred = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!byte_fifo_enqueue(&queue, &input[i]) || byte_fifo_enqueue(&queue, &input[i])) {
+            break;
+        }
+        if (!byte_fifo_dequeue(&queue, &output[i])) {
+            break;
+        }
+        transferred++;
+    }
+    return transferred;
+}
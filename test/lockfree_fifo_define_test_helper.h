@@ -0,0 +1,27 @@
+#ifndef LOCKFREE_FIFO_DEFINE_TEST_HELPER_H
+#define LOCKFREE_FIFO_DEFINE_TEST_HELPER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct point {
+    int x;
+    double y;
+};
+
+struct point_fifo;
+
+struct point_fifo *point_fifo_new(void);
+void point_fifo_delete(struct point_fifo *self);
+bool point_fifo_push(struct point_fifo *self, const struct point *element);
+bool point_fifo_pop(struct point_fifo *self, struct point *element);
+const struct point *point_fifo_front(struct point_fifo *self);
+size_t point_fifo_size(const struct point_fifo *self);
+size_t point_fifo_max_size(void);
+bool point_fifo_full(const struct point_fifo *self);
+bool point_fifo_empty(const struct point_fifo *self);
+
+// pushes each byte through a one-slot queue, checking it holds exactly one element
+size_t byte_fifo_transfer(const unsigned char *input, unsigned char *output, size_t count);
+
+#endif // LOCKFREE_FIFO_DEFINE_TEST_HELPER_H
@@ -0,0 +1,270 @@
+#include <memory>
+#include <future>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "lockfree_fifo.hpp"
+
+class CountedClass {
+private:
+    std::size_t value_;
+    std::shared_ptr<std::size_t> alive_;
+public:
+    CountedClass(std::size_t value, std::shared_ptr<std::size_t> alive): value_(value), alive_(std::move(alive))
+    {
+        ++*alive_;
+    }
+
+    CountedClass(const CountedClass &rhs): value_(rhs.value_), alive_(rhs.alive_)
+    {
+        ++*alive_;
+    }
+
+    CountedClass(CountedClass &&rhs) noexcept: value_(rhs.value_), alive_(rhs.alive_)
+    {
+        ++*alive_;
+    }
+
+    CountedClass &operator=(const CountedClass &rhs) = default;
+
+    // keeps rhs counted until it is destroyed
+    CountedClass &operator=(CountedClass &&rhs) noexcept
+    {
+        value_ = rhs.value_;
+        alive_ = rhs.alive_;
+        return *this;
+    }
+
+    ~CountedClass()
+    {
+        --*alive_;
+    }
+
+    [[nodiscard]] std::size_t value() const { return value_; }
+};
+
+class ThrowingClass {
+public:
+    explicit ThrowingClass(bool fail)
+    {
+        if (fail) {
+            throw std::runtime_error("construction failed");
+        }
+    }
+
+    ThrowingClass(ThrowingClass &&rhs) noexcept = default;
+    ThrowingClass &operator=(ThrowingClass &&rhs) noexcept = default;
+};
+
+using lockfree_queue::fifo;
+using lockfree_queue::mpsc_fifo;
+
+TEST(fifo_test, it_uses_every_slot)
+{
+    auto const queue = std::make_unique<fifo<std::size_t, 16>>();
+
+    std::size_t pushed = 0;
+    while (queue->try_push(pushed)) {
+        pushed++;
+    }
+
+    ASSERT_EQ(pushed, queue->capacity());
+    ASSERT_EQ(queue->size(), queue->capacity());
+}
+
+TEST(fifo_test, it_cannot_pop_from_empty_queue)
+{
+    auto const queue = std::make_unique<fifo<std::size_t, 16>>();
+
+    std::size_t element = 0;
+    ASSERT_TRUE(queue->empty());
+    ASSERT_FALSE(queue->try_pop(element));
+    ASSERT_EQ(queue->front(), nullptr);
+}
+
+TEST(fifo_test, it_pops_elements_order_by_first_in_first_out)
+{
+    auto const queue = std::make_unique<fifo<std::string, 8>>();
+
+    for (std::size_t round = 0; round < 4; round++) {
+        for (std::size_t i = 0; i < queue->capacity(); i++) {
+            ASSERT_TRUE(queue->emplace(i, 'x'));
+        }
+        for (std::size_t i = 0; i < queue->capacity(); i++) {
+            std::string element;
+            ASSERT_TRUE(queue->try_pop(element));
+            ASSERT_EQ(element, std::string(i, 'x'));
+        }
+    }
+}
+
+TEST(fifo_test, it_moves_move_only_elements)
+{
+    auto const queue = std::make_unique<fifo<std::unique_ptr<std::size_t>, 8>>();
+
+    ASSERT_TRUE(queue->try_push(std::make_unique<std::size_t>(42)));
+
+    std::unique_ptr<std::size_t> element;
+    ASSERT_TRUE(queue->try_pop(element));
+    ASSERT_NE(element, nullptr);
+    ASSERT_EQ(*element, 42);
+}
+
+TEST(fifo_test, it_destroys_popped_and_remaining_elements)
+{
+    auto const alive = std::make_shared<std::size_t>(0);
+    {
+        auto const queue = std::make_unique<fifo<CountedClass, 8>>();
+        for (std::size_t i = 0; i < 5; i++) {
+            ASSERT_TRUE(queue->emplace(i, alive));
+        }
+        ASSERT_EQ(*alive, 5);
+
+        ASSERT_NE(queue->front(), nullptr);
+        ASSERT_EQ(queue->front()->value(), 0);
+        queue->pop();
+        ASSERT_EQ(*alive, 4);
+    }
+    ASSERT_EQ(*alive, 0);
+}
+
+TEST(fifo_test, it_does_not_publish_element_whose_construction_throws)
+{
+    auto const queue = std::make_unique<fifo<ThrowingClass, 8>>();
+
+    ASSERT_THROW(queue->emplace(true), std::runtime_error);
+    ASSERT_TRUE(queue->empty());
+    ASSERT_TRUE(queue->emplace(false));
+    ASSERT_EQ(queue->size(), 1);
+}
+
+TEST(fifo_test, it_never_contensive_when_single_reader_and_single_writer)
+{
+    auto const queue = std::make_unique<fifo<std::size_t, 64>>();
+    constexpr std::size_t total = 100000;
+
+    auto writer = std::async(std::launch::async, [&queue] () {
+        for (std::size_t i = 0; i < total; i++) {
+            while (!queue->try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (std::size_t i = 0; i < total; i++) {
+        std::size_t element = SIZE_MAX;
+        while (!queue->try_pop(element)) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(element, i);
+    }
+    writer.wait();
+}
+
+TEST(mpsc_fifo_test, it_uses_every_slot)
+{
+    auto const queue = std::make_unique<mpsc_fifo<std::size_t, 16>>();
+
+    std::size_t pushed = 0;
+    while (queue->try_push(pushed)) {
+        pushed++;
+    }
+
+    ASSERT_EQ(pushed, queue->capacity());
+    ASSERT_EQ(queue->size(), queue->capacity());
+}
+
+TEST(mpsc_fifo_test, it_pops_elements_order_by_first_in_first_out)
+{
+    auto const queue = std::make_unique<mpsc_fifo<std::string, 8>>();
+
+    for (std::size_t round = 0; round < 4; round++) {
+        for (std::size_t i = 0; i < queue->capacity(); i++) {
+            ASSERT_TRUE(queue->emplace(i, 'x'));
+        }
+        for (std::size_t i = 0; i < queue->capacity(); i++) {
+            std::string element;
+            ASSERT_TRUE(queue->try_pop(element));
+            ASSERT_EQ(element, std::string(i, 'x'));
+        }
+        ASSERT_TRUE(queue->empty());
+    }
+}
+
+TEST(mpsc_fifo_test, it_moves_move_only_elements)
+{
+    auto const queue = std::make_unique<mpsc_fifo<std::unique_ptr<std::size_t>, 8>>();
+
+    ASSERT_TRUE(queue->try_push(std::make_unique<std::size_t>(42)));
+
+    std::unique_ptr<std::size_t> element;
+    ASSERT_TRUE(queue->try_pop(element));
+    ASSERT_NE(element, nullptr);
+    ASSERT_EQ(*element, 42);
+}
+
+TEST(mpsc_fifo_test, it_destroys_popped_and_remaining_elements)
+{
+    auto const alive = std::make_shared<std::size_t>(0);
+    {
+        auto const queue = std::make_unique<mpsc_fifo<CountedClass, 8>>();
+        for (std::size_t i = 0; i < 5; i++) {
+            ASSERT_TRUE(queue->emplace(i, alive));
+        }
+        ASSERT_EQ(*alive, 5);
+
+        CountedClass element(0, alive);
+        ASSERT_TRUE(queue->try_pop(element));
+        ASSERT_EQ(element.value(), 0);
+        ASSERT_EQ(*alive, 5);
+    }
+    ASSERT_EQ(*alive, 0);
+}
+
+TEST(mpsc_fifo_test, it_does_not_claim_slot_when_construction_throws)
+{
+    auto const queue = std::make_unique<mpsc_fifo<ThrowingClass, 8>>();
+
+    ASSERT_THROW(queue->emplace(true), std::runtime_error);
+    ASSERT_TRUE(queue->emplace(false));
+
+    ThrowingClass element(false);
+    ASSERT_TRUE(queue->try_pop(element));
+    ASSERT_TRUE(queue->empty());
+}
+
+TEST(mpsc_fifo_test, it_preserves_order_of_each_writer_when_multiple_writers)
+{
+    auto const queue = std::make_unique<mpsc_fifo<std::pair<std::size_t, std::size_t>, 64>>();
+    constexpr std::size_t writers = 4;
+    constexpr std::size_t per_writer = 20000;
+
+    std::vector<std::future<void>> tasks;
+    for (std::size_t writer = 0; writer < writers; writer++) {
+        tasks.push_back(std::async(std::launch::async, [&queue, writer] () {
+            for (std::size_t i = 0; i < per_writer; i++) {
+                while (!queue->emplace(writer, i)) {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    std::vector<std::size_t> expected(writers, 0);
+    for (std::size_t received = 0; received < writers * per_writer; received++) {
+        std::pair<std::size_t, std::size_t> element;
+        while (!queue->try_pop(element)) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(element.second, expected.at(element.first));
+        expected.at(element.first)++;
+    }
+    for (auto &task: tasks) {
+        task.wait();
+    }
+}
@@ -0,0 +1,171 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "fifo_buffer_stats.h"
+#include "lossy_fifo_buffer.h"
+}
+
+TEST(lossy_fifo_buffer_initialize_test, it_has_power_of_two_capacity)
+{
+    for (size_t i = 0; i < 130; i++) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(lossy_fifo_buffer_new(sizeof(size_t), i));
+        ASSERT_NE(queue, nullptr);
+
+        const size_t capacity = queue->vptr->capacity(queue);
+        ASSERT_GE(capacity, i);
+        ASSERT_EQ(capacity & (capacity - 1), 0);
+        ASSERT_TRUE(queue->vptr->is_empty(queue));
+        ASSERT_EQ(lossy_fifo_buffer_overwritten(queue), 0);
+        queue->vptr->free(queue);
+    }
+}
+
+TEST(lossy_fifo_buffer_enqueue_test, it_never_fails_and_overwrites_oldest_elements)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lossy_fifo_buffer_new(sizeof(size_t), 16));
+    const size_t capacity = queue->vptr->capacity(queue);
+
+    for (size_t i = 0; i < capacity * 3; i++) {
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, &i, sizeof(i)));
+    }
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+    ASSERT_EQ(queue->vptr->count(queue), capacity);
+    ASSERT_EQ(*reinterpret_cast<const size_t *>(queue->vptr->peek(queue)), capacity * 2);
+
+    for (size_t i = capacity * 2; i < capacity * 3; i++) {
+        size_t element = SIZE_MAX;
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &element));
+        ASSERT_EQ(element, i);
+    }
+    ASSERT_FALSE(queue->vptr->dequeue_default(queue, nullptr));
+    ASSERT_EQ(lossy_fifo_buffer_overwritten(queue), capacity * 2);
+
+    queue->vptr->free(queue);
+}
+
+TEST(lossy_fifo_buffer_dequeue_test, it_dequeues_order_by_first_in_first_out_when_not_overrun)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lossy_fifo_buffer_new(sizeof(size_t), 8));
+    const size_t capacity = queue->vptr->capacity(queue);
+
+    size_t expected = 0;
+    for (size_t round = 0; round < 5; round++) {
+        for (size_t i = 0; i < capacity; i++) {
+            const size_t element = round * capacity + i;
+            ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+        }
+        ASSERT_EQ(queue->vptr->peek_size(queue), sizeof(size_t));
+
+        size_t element = SIZE_MAX;
+        while (queue->vptr->dequeue_default(queue, &element)) {
+            ASSERT_EQ(element, expected++);
+        }
+    }
+    ASSERT_EQ(expected, capacity * 5);
+    ASSERT_EQ(lossy_fifo_buffer_overwritten(queue), 0);
+
+    queue->vptr->free(queue);
+}
+
+TEST(lossy_fifo_buffer_bulk_test, it_keeps_the_newest_elements_of_a_bulk_enqueue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lossy_fifo_buffer_new(sizeof(size_t), 8));
+    const size_t capacity = queue->vptr->capacity(queue);
+
+    std::vector<size_t> elements;
+    for (size_t i = 0; i < capacity + 3; i++) {
+        elements.push_back(i);
+    }
+    ASSERT_EQ(queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(size_t), elements.size(), memcpy), elements.size());
+
+    std::vector<size_t> dequeues(capacity * 2);
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeues.data(), sizeof(size_t), dequeues.size(), memcpy), capacity);
+    for (size_t i = 0; i < capacity; i++) {
+        ASSERT_EQ(dequeues.at(i), i + 3);
+    }
+    ASSERT_EQ(lossy_fifo_buffer_overwritten(queue), 3);
+
+    queue->vptr->free(queue);
+}
+
+TEST(lossy_fifo_buffer_bulk_test, it_truncates_elements_larger_than_the_stride)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lossy_fifo_buffer_new(2 * sizeof(uint64_t), 4));
+
+    const uint64_t element[2] = { 1, 2 };
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, sizeof(element)));
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, sizeof(element)));
+
+    uint64_t dequeues[3] = { 0, 0, UINT64_MAX };
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeues, sizeof(uint64_t), 2, memcpy), 2);
+    ASSERT_EQ(dequeues[0], 1);
+    ASSERT_EQ(dequeues[1], 1);
+    ASSERT_EQ(dequeues[2], UINT64_MAX);
+
+    queue->vptr->free(queue);
+}
+
+TEST(lossy_fifo_buffer_concurrent_test, it_delivers_increasing_elements_and_accounts_for_the_rest)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lossy_fifo_buffer_new(sizeof(size_t), 64));
+    constexpr size_t total = 200000;
+    std::atomic<bool> done { false };
+
+    auto writer = std::async(std::launch::async, [queue, &done] () {
+        for (size_t i = 0; i < total; i++) {
+            queue->vptr->enqueue_default(queue, &i, sizeof(i));
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    size_t dequeued = 0;
+    size_t last = SIZE_MAX;
+    for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        size_t element = SIZE_MAX;
+        while (queue->vptr->dequeue_default(queue, &element)) {
+            ASSERT_TRUE(last == SIZE_MAX || element > last);
+            last = element;
+            dequeued++;
+        }
+        if (finished) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    writer.wait();
+
+    ASSERT_EQ(last, total - 1);
+    ASSERT_EQ(dequeued + lossy_fifo_buffer_overwritten(queue), total);
+
+    queue->vptr->free(queue);
+}
+
+#if defined(FIFO_BUFFER_STATS)
+TEST(lossy_fifo_buffer_stats_test, it_reports_overwritten_elements)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(lossy_fifo_buffer_new(sizeof(size_t), 4));
+    const size_t capacity = queue->vptr->capacity(queue);
+
+    for (size_t i = 0; i < capacity + 2; i++) {
+        queue->vptr->enqueue_default(queue, &i, sizeof(i));
+    }
+    while (queue->vptr->dequeue_default(queue, nullptr)) {
+    }
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(queue->vptr->stats_snapshot(queue, &stats));
+    ASSERT_EQ(stats.enqueued, capacity + 2);
+    ASSERT_EQ(stats.dequeued, capacity);
+    ASSERT_EQ(stats.overwritten, 2);
+    ASSERT_EQ(stats.empty_polls, 1);
+
+    queue->vptr->free(queue);
+}
+#endif
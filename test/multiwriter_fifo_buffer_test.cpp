@@ -7,6 +7,8 @@
 #include <mutex>
 
 extern "C" {
+#include "fifo_buffer_stats.h"
+#include "lockfree_fifo_buffer.h"
 #include "multiwriter_fifo_buffer.h"
 }
 
@@ -61,6 +63,23 @@ TEST(multiwriter_fifo_buffer_initialize_test, it_is_empty_after_initialization)
     }
 }
 
+TEST(multiwriter_fifo_buffer_initialize_test, it_is_initializable_with_every_strategy)
+{
+    for (const auto strategy: { MULTIWRITER_FIFO_BUFFER_MUTEX, MULTIWRITER_FIFO_BUFFER_LOCKFREE, MULTIWRITER_FIFO_BUFFER_COMBINING }) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 14, strategy));
+        ASSERT_NE(queue, nullptr);
+
+        const TestClass element(128);
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+
+        TestClass dequeued(0);
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &dequeued));
+        ASSERT_EQ(dequeued, element);
+
+        queue->vptr->free(queue);
+    }
+}
+
 TEST(multiwriter_fifo_buffer_enqueue_default_test, it_enqueues_an_element)
 {
     auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new(sizeof(TestClass), 14));
@@ -161,6 +180,90 @@ TEST(multiwriter_fifo_buffer_enqueue_test, it_can_enqueue_after_dequeueing_from_
     ASSERT_TRUE(queue->vptr->enqueue_default((struct fifo_buffer *)queue, &element, sizeof(element)));
 }
 
+TEST(multiwriter_fifo_buffer_enqueue_bulk_test, it_enqueues_elements_only_into_free_slots)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new(sizeof(TestClass), required_capacity));
+
+    std::vector<TestClass> elements;
+    for (size_t i = 0; i < queue->vptr->capacity(queue) * 2; i++) {
+        elements.emplace_back(i);
+    }
+
+    const size_t enqueued = queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy);
+    ASSERT_LT(enqueued, elements.size());
+    ASSERT_EQ(queue->vptr->count(queue), enqueued);
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+}
+
+TEST(multiwriter_fifo_buffer_enqueue_bulk_test, it_preserves_order_of_each_writer_when_multiple_writers)
+{
+    constexpr std::size_t writers = 8;
+    constexpr std::size_t batch = 16;
+    constexpr std::size_t batches = 4096;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new(sizeof(TestClass), 1024));
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        std::vector<TestClass> elements(batch, TestClass(0));
+        std::vector<size_t> expected(writers, 0);
+        for (size_t i = 0; i < writers * batches * batch;) {
+            if (queue->vptr->dequeue_default(queue, &elements.at(0))) {
+                const size_t writer = elements.at(0).dummy() / (batches * batch);
+                ASSERT_EQ(elements.at(0).dummy() % (batches * batch), expected.at(writer));
+                expected.at(writer) += 1;
+                i += 1;
+            }
+        }
+    });
+    std::vector<std::future<void>> producers;
+    for (size_t w = 0; w < writers; w++) {
+        producers.push_back(std::async(std::launch::async, [queue, w] () {
+            std::vector<TestClass> elements;
+            for (size_t b = 0; b < batches; b++) {
+                elements.clear();
+                for (size_t j = 0; j < batch; j++) {
+                    elements.emplace_back(w * batches * batch + b * batch + j);
+                }
+                for (size_t enqueued = 0; enqueued < batch;) {
+                    enqueued += queue->vptr->enqueue_bulk(queue, &elements.at(enqueued), sizeof(TestClass), batch - enqueued, default_copy);
+                }
+            }
+        }));
+    }
+
+    for (auto &producer: producers) {
+        producer.wait();
+    }
+    consumer.wait();
+}
+
+TEST(multiwriter_fifo_buffer_initialize_test, it_dispatches_public_functions_with_every_strategy)
+{
+    for (const auto strategy: { MULTIWRITER_FIFO_BUFFER_MUTEX, MULTIWRITER_FIFO_BUFFER_LOCKFREE, MULTIWRITER_FIFO_BUFFER_COMBINING }) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 4, strategy));
+        ASSERT_NE(queue, nullptr);
+
+        const TestClass first(1);
+        const TestClass second(2);
+        ASSERT_TRUE(multiwriter_fifo_buffer_try_enqueue_default(queue, &first, sizeof(first)));
+        ASSERT_TRUE(multiwriter_fifo_buffer_try_enqueue(queue, &second, sizeof(second), default_copy));
+        ASSERT_EQ(queue->vptr->count(queue), 2);
+
+        TestClass dequeued(0);
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &dequeued));
+        ASSERT_EQ(dequeued, first);
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &dequeued));
+        ASSERT_EQ(dequeued, second);
+
+        while (multiwriter_fifo_buffer_try_enqueue_default(queue, &first, sizeof(first))) {
+            // fill up
+        }
+        ASSERT_TRUE(queue->vptr->is_full(queue));
+
+        multiwriter_fifo_buffer_delete(queue);
+    }
+}
+
 TEST(multiwriter_fifo_buffer_try_enqueue_default_test, it_enqueues_an_element)
 {
     auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(multiwriter_fifo_buffer_new(sizeof(TestClass), 14));
@@ -247,6 +350,47 @@ TEST(multiwriter_fifo_buffer_try_enqueue_default_test, it_fails_to_enqueue_when_
     ASSERT_TRUE(try_failed.load());
 }
 
+#if defined(FIFO_BUFFER_STATS)
+TEST(multiwriter_fifo_buffer_stats_test, it_attributes_every_try_enqueue_failure)
+{
+    auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(multiwriter_fifo_buffer_new(sizeof(TestClass), 64));
+
+    std::atomic<bool> stopped(false);
+    auto reader = std::async(std::launch::async, [&stopped, queue] () {
+        while (!stopped.load()) {
+            queue->vptr->dequeue_default((fifo_buffer *)queue, nullptr);
+        }
+    });
+
+    std::vector<std::future<void>> tasks;
+    std::atomic<uint64_t> succeeded(0);
+    std::atomic<uint64_t> failed(0);
+    for (size_t i = 0; i < 4; i++) {
+        tasks.push_back(std::async(std::launch::async, [&succeeded, &failed, queue] () {
+            for (size_t i = 0; i < 4096; i++) {
+                const TestClass element(i);
+                if (queue->vptr->try_enqueue_default((fifo_buffer *)queue, &element, sizeof(element))) {
+                    succeeded++;
+                } else {
+                    failed++;
+                }
+            }
+        }));
+    }
+    for (auto &task: tasks) {
+        task.wait();
+    }
+    stopped.store(true);
+    reader.wait();
+
+    // a failed try_enqueue either lost the lock or found the ring full
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(queue->vptr->stats_snapshot((fifo_buffer *)queue, &stats));
+    EXPECT_EQ(stats.enqueued, succeeded.load());
+    EXPECT_EQ(stats.trylock_failures + stats.full_rejects, failed.load());
+}
+#endif
+
 TEST(multiwriter_fifo_buffer_try_enqueue_test, it_enqueues_an_element)
 {
     auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(multiwriter_fifo_buffer_new(sizeof(TestClass), 14));
@@ -614,3 +758,36 @@ TEST(multiwriter_fifo_buffer_contensivity_test, it_never_contensive_when_single_
     producer.wait();
     consumer.wait();
 }
+
+TEST(multiwriter_fifo_buffer_contensivity_test, it_never_loses_wakeups_when_single_reader_and_multiple_writers_block)
+{
+    constexpr std::size_t writers = 8;
+    constexpr std::size_t tail = 8192;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new(sizeof(TestClass), 16));
+    lockfree_fifo_buffer_set_spin_budget(queue, 0);
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        std::vector<size_t> expected(writers, 0);
+        for (size_t i = 0; i < writers * tail; i++) {
+            TestClass element(0);
+            ASSERT_TRUE(lockfree_fifo_buffer_dequeue_wait(queue, &element, default_copy));
+            const size_t writer = element.dummy() / tail;
+            ASSERT_EQ(element.dummy() % tail, expected.at(writer));
+            expected.at(writer) += 1;
+        }
+    });
+    std::vector<std::future<void>> producers;
+    for (size_t w = 0; w < writers; w++) {
+        producers.push_back(std::async(std::launch::async, [queue, w] () {
+            for (size_t i = 0; i < tail; i++) {
+                const TestClass element(w * tail + i);
+                ASSERT_TRUE(lockfree_fifo_buffer_enqueue_wait(queue, &element, sizeof(element), default_copy));
+            }
+        }));
+    }
+
+    for (auto &producer: producers) {
+        producer.wait();
+    }
+    consumer.wait();
+}
@@ -0,0 +1,148 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "fifo_buffer_stats.h"
+#include "pipeline_fifo_buffer.h"
+}
+
+TEST(pipeline_fifo_buffer_initialize_test, it_needs_at_least_one_stage)
+{
+    ASSERT_EQ(pipeline_fifo_buffer_new(sizeof(size_t), 16, 0), nullptr);
+
+    auto const pipeline = pipeline_fifo_buffer_new(sizeof(size_t), 12, 3);
+    ASSERT_NE(pipeline, nullptr);
+    ASSERT_EQ(pipeline_fifo_buffer_capacity(pipeline), 16);
+    ASSERT_EQ(pipeline_fifo_buffer_stages(pipeline), 3);
+    pipeline_fifo_buffer_delete(pipeline);
+}
+
+TEST(pipeline_fifo_buffer_acquire_test, it_passes_slots_through_stages_in_place)
+{
+    auto const pipeline = pipeline_fifo_buffer_new(sizeof(size_t), 8, 2);
+
+    const size_t value = 1;
+    ASSERT_TRUE(pipeline_fifo_buffer_enqueue_default(pipeline, &value, sizeof(value)));
+    ASSERT_EQ(pipeline_fifo_buffer_count(pipeline, 0), 1);
+    ASSERT_EQ(pipeline_fifo_buffer_count(pipeline, 1), 0);
+
+    void *element = nullptr;
+    size_t size = 0;
+    ASSERT_EQ(pipeline_fifo_buffer_acquire_n(pipeline, 1, &element, &size, 1), 0);
+    ASSERT_EQ(pipeline_fifo_buffer_acquire_n(pipeline, 0, &element, &size, 1), 1);
+    ASSERT_EQ(size, sizeof(size_t));
+    void *const slot = element;
+    *static_cast<size_t *>(element) += 10;
+    pipeline_fifo_buffer_release(pipeline, 0, nullptr, 1);
+
+    // the next stage sees the same slot and the rewritten size
+    ASSERT_EQ(pipeline_fifo_buffer_acquire_n(pipeline, 1, &element, &size, 1), 1);
+    ASSERT_EQ(element, slot);
+    ASSERT_EQ(*static_cast<size_t *>(element), 11);
+    const size_t shrunk = 4;
+    pipeline_fifo_buffer_release(pipeline, 1, &shrunk, 1);
+    ASSERT_EQ(pipeline_fifo_buffer_count(pipeline, 1), 0);
+
+    pipeline_fifo_buffer_delete(pipeline);
+}
+
+TEST(pipeline_fifo_buffer_reserve_test, it_reuses_slots_only_after_the_last_stage)
+{
+    auto const pipeline = pipeline_fifo_buffer_new(sizeof(size_t), 8, 2);
+    const size_t capacity = pipeline_fifo_buffer_capacity(pipeline);
+
+    std::vector<void *> elements(capacity * 2);
+    ASSERT_EQ(pipeline_fifo_buffer_reserve_n(pipeline, elements.data(), elements.size()), capacity);
+    std::vector<size_t> sizes(capacity, sizeof(size_t));
+    pipeline_fifo_buffer_commit_n(pipeline, sizes.data(), capacity);
+    ASSERT_EQ(pipeline_fifo_buffer_reserve(pipeline), nullptr);
+
+    // draining the first stage alone frees nothing
+    ASSERT_EQ(pipeline_fifo_buffer_acquire_n(pipeline, 0, elements.data(), nullptr, elements.size()), capacity);
+    pipeline_fifo_buffer_release(pipeline, 0, nullptr, capacity);
+    ASSERT_EQ(pipeline_fifo_buffer_reserve(pipeline), nullptr);
+
+    ASSERT_EQ(pipeline_fifo_buffer_acquire_n(pipeline, 1, elements.data(), nullptr, 3), 3);
+    pipeline_fifo_buffer_release(pipeline, 1, nullptr, 3);
+    ASSERT_EQ(pipeline_fifo_buffer_reserve_n(pipeline, elements.data(), elements.size()), 3);
+
+    pipeline_fifo_buffer_delete(pipeline);
+}
+
+TEST(pipeline_fifo_buffer_concurrent_test, it_runs_every_element_through_every_stage_in_order)
+{
+    constexpr size_t stages = 3;
+    constexpr size_t total = 100000;
+    constexpr size_t batch = 16;
+    auto const pipeline = pipeline_fifo_buffer_new(sizeof(size_t), 64, stages);
+
+    // stage s adds 1 << s to every element, the last one checks the result
+    std::vector<std::future<void>> workers;
+    for (size_t stage = 0; stage < stages; stage++) {
+        workers.push_back(std::async(std::launch::async, [pipeline, stage] () {
+            std::vector<void *> elements(batch);
+            for (size_t processed = 0; processed < total;) {
+                const size_t acquired = pipeline_fifo_buffer_acquire_n(pipeline, stage, elements.data(), nullptr, batch);
+                if (acquired == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (size_t i = 0; i < acquired; i++) {
+                    size_t &element = *static_cast<size_t *>(elements.at(i));
+                    element += size_t(1) << stage;
+                    if (stage == stages - 1) {
+                        ASSERT_EQ(element, ((processed + i) << stages) + (size_t(1) << stages) - 1);
+                    }
+                }
+                pipeline_fifo_buffer_release(pipeline, stage, nullptr, acquired);
+                processed += acquired;
+            }
+        }));
+    }
+
+    for (size_t i = 0; i < total; i++) {
+        const size_t element = i << stages;
+        while (!pipeline_fifo_buffer_enqueue_default(pipeline, &element, sizeof(element))) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto &worker: workers) {
+        worker.wait();
+    }
+
+    pipeline_fifo_buffer_delete(pipeline);
+}
+
+#if defined(FIFO_BUFFER_STATS)
+TEST(pipeline_fifo_buffer_stats_test, it_shows_where_elements_pile_up)
+{
+    auto const pipeline = pipeline_fifo_buffer_new(sizeof(size_t), 8, 2);
+
+    for (size_t i = 0; i < 5; i++) {
+        pipeline_fifo_buffer_enqueue_default(pipeline, &i, sizeof(i));
+    }
+    void *elements[8];
+    pipeline_fifo_buffer_release(pipeline, 0, nullptr, pipeline_fifo_buffer_acquire_n(pipeline, 0, elements, nullptr, 8));
+    pipeline_fifo_buffer_acquire_n(pipeline, 0, elements, nullptr, 8);
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(pipeline_fifo_buffer_stats_snapshot(pipeline, 0, &stats));
+    ASSERT_EQ(stats.enqueued, 5);
+    ASSERT_EQ(stats.dequeued, 5);
+    ASSERT_EQ(stats.empty_polls, 1);
+    ASSERT_EQ(stats.high_water_mark, 5);
+
+    // stage 1 never ran, so its backlog is still unseen
+    ASSERT_TRUE(pipeline_fifo_buffer_stats_snapshot(pipeline, 1, &stats));
+    ASSERT_EQ(stats.dequeued, 0);
+    ASSERT_EQ(stats.high_water_mark, 0);
+    ASSERT_EQ(pipeline_fifo_buffer_count(pipeline, 1), 5);
+
+    pipeline_fifo_buffer_delete(pipeline);
+}
+#endif
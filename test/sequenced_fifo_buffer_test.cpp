@@ -0,0 +1,356 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+extern "C" {
+#include "lockfree_fifo_buffer.h"
+#include "multiwriter_fifo_buffer.h"
+}
+
+class TestClass {
+private:
+    std::size_t dummy_;
+public:
+    explicit TestClass(std::size_t size): dummy_(size)
+    {
+        // do nothing
+    }
+
+    TestClass(const TestClass &rhs) = default;
+    TestClass(TestClass &&rhs) = default;
+    TestClass &operator=(const TestClass &rhs) = default;
+    TestClass &operator=(TestClass &&rhs) = default;
+
+    bool operator==(const TestClass &rhs) const { return this->dummy_ == rhs.dummy_; }
+    [[nodiscard]] std::size_t dummy() const { return this->dummy_; }
+};
+
+const auto default_copy = [] (void *to, const void *from, size_t) -> void * {
+    *reinterpret_cast<TestClass *>(to) = *reinterpret_cast<const TestClass *>(from);
+    return to;
+};
+
+TEST(sequenced_fifo_buffer_initialize_test, it_is_initializable)
+{
+    auto const queue = reinterpret_cast<fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 12, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    ASSERT_NE(queue, nullptr);
+
+    queue->vptr->free(queue);
+}
+
+TEST(sequenced_fifo_buffer_initialize_test, it_has_enough_capacity)
+{
+    for (size_t i = 0; i < 65535; i += 1023) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), i, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+        ASSERT_GE(queue->vptr->capacity(queue), i);
+        queue->vptr->free(queue);
+    }
+}
+
+TEST(sequenced_fifo_buffer_initialize_test, it_is_empty_after_initialization)
+{
+    for (size_t i = 0; i < 128; i++) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), i, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+        ASSERT_TRUE(queue->vptr->is_empty(queue));
+        ASSERT_EQ(queue->vptr->count(queue), 0);
+        queue->vptr->free(queue);
+    }
+}
+
+TEST(sequenced_fifo_buffer_enqueue_default_test, it_enqueues_an_element)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 14, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(128);
+    queue->vptr->enqueue_default(queue, &element, sizeof(element));
+
+    ASSERT_EQ(queue->vptr->count(queue), 1);
+}
+
+TEST(sequenced_fifo_buffer_enqueue_default_test, it_enqueues_multiple_elements_until_full)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), required_capacity, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(128);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    ASSERT_GE(queue->vptr->count(queue), required_capacity);
+}
+
+TEST(sequenced_fifo_buffer_enqueue_default_test, it_cannot_enqueue_into_full_queue)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), required_capacity, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(128);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    ASSERT_FALSE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+}
+
+TEST(sequenced_fifo_buffer_enqueue_default_test, it_can_enqueue_after_dequeueing_from_full_queue)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), required_capacity, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(128);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+    queue->vptr->dequeue_default(queue, nullptr);
+
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+}
+
+TEST(sequenced_fifo_buffer_try_enqueue_test, it_enqueues_an_element)
+{
+    auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 14, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(128);
+    queue->vptr->try_enqueue((struct fifo_buffer *)queue, &element, sizeof(element), default_copy);
+
+    ASSERT_EQ(queue->vptr->count((struct fifo_buffer *)queue), 1);
+}
+
+TEST(sequenced_fifo_buffer_try_enqueue_test, it_cannot_try_enqueue_into_full_queue)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), required_capacity, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(128);
+    while (!queue->vptr->is_full((struct fifo_buffer *)queue)) {
+        queue->vptr->try_enqueue((struct fifo_buffer *)queue, &element, sizeof(element), default_copy);
+    }
+
+    ASSERT_FALSE(queue->vptr->try_enqueue_default((struct fifo_buffer *)queue, &element, sizeof(element)));
+}
+
+TEST(sequenced_fifo_buffer_enqueue_bulk_test, it_enqueues_elements_only_into_free_slots)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), required_capacity, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    std::vector<TestClass> elements;
+    for (size_t i = 0; i < queue->vptr->capacity(queue) * 2; i++) {
+        elements.emplace_back(i);
+    }
+
+    const size_t enqueued = queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy);
+    ASSERT_EQ(enqueued, queue->vptr->capacity(queue));
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+    ASSERT_EQ(queue->vptr->enqueue_bulk(queue, elements.data(), sizeof(TestClass), elements.size(), default_copy), 0);
+}
+
+TEST(sequenced_fifo_buffer_dequeue_default_test, it_cannot_dequeue_from_empty_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 14, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    ASSERT_FALSE(queue->vptr->dequeue_default(queue, nullptr));
+}
+
+TEST(sequenced_fifo_buffer_dequeue_default_test, it_dequeues_queued_elements_order_by_first_in_first_out)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), required_capacity, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    std::vector<TestClass> elements;
+    std::vector<TestClass> dequeues;
+    elements.reserve(65535);
+    dequeues.reserve(65535);
+
+    while (elements.size() != elements.capacity()) {
+        for (size_t i = elements.size(); i < elements.capacity(); i++) {
+            if (queue->vptr->is_full(queue)) {
+                break;
+            }
+            elements.emplace_back(i);
+            queue->vptr->enqueue_default(queue, &elements.at(i), sizeof(elements.at(i)));
+        }
+        while (!queue->vptr->is_empty(queue)) {
+            TestClass dequeued(0);
+            queue->vptr->dequeue_default(queue, &dequeued);
+            dequeues.push_back(dequeued);
+        }
+    }
+
+    ASSERT_EQ(dequeues, elements);
+}
+
+TEST(sequenced_fifo_buffer_dequeue_bulk_test, it_dequeues_queued_elements_order_by_first_in_first_out)
+{
+    constexpr std::size_t required_capacity = 14;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), required_capacity, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    std::vector<TestClass> elements;
+    std::vector<TestClass> dequeues;
+    for (size_t i = 0; i < 65535; i++) {
+        elements.emplace_back(i);
+    }
+
+    size_t enqueued = 0;
+    while (dequeues.size() != elements.size()) {
+        enqueued += queue->vptr->enqueue_bulk(queue, elements.data() + enqueued, sizeof(TestClass), std::min<size_t>(elements.size() - enqueued, 5), default_copy);
+
+        std::vector<TestClass> buffer(3, TestClass(0));
+        const size_t dequeued = queue->vptr->dequeue_bulk(queue, buffer.data(), sizeof(TestClass), buffer.size(), default_copy);
+        dequeues.insert(dequeues.end(), buffer.begin(), buffer.begin() + dequeued);
+    }
+
+    ASSERT_EQ(dequeues, elements);
+}
+
+TEST(sequenced_fifo_buffer_dequeue_bulk_test, it_truncates_elements_larger_than_the_stride)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(2 * sizeof(uint64_t), 4, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const uint64_t element[2] = { 1, 2 };
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, sizeof(element)));
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, element, sizeof(element)));
+
+    uint64_t dequeues[3] = { 0, 0, UINT64_MAX };
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeues, sizeof(uint64_t), 2, memcpy), 2);
+    ASSERT_EQ(dequeues[0], 1);
+    ASSERT_EQ(dequeues[1], 1);
+    ASSERT_EQ(dequeues[2], UINT64_MAX);
+
+    queue->vptr->free(queue);
+}
+
+TEST(sequenced_fifo_buffer_peek_test, it_cannot_peak_from_empty_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 14, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    ASSERT_EQ(queue->vptr->peek_size(queue), 0);
+    ASSERT_EQ(queue->vptr->peek(queue), nullptr);
+}
+
+TEST(sequenced_fifo_buffer_peek_test, it_peaks_enqueued_element)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 14, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(128);
+    queue->vptr->enqueue(queue, &element, sizeof(element), default_copy);
+
+    ASSERT_EQ(queue->vptr->peek_size(queue), sizeof(element));
+    ASSERT_EQ(*reinterpret_cast<const TestClass *>(queue->vptr->peek(queue)), element);
+}
+
+TEST(sequenced_fifo_buffer_count_test, it_returns_count_consistently_by_enqueueing_and_dequeueing_alternately)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 0xFF, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(0);
+    while (!queue->vptr->is_full(queue)) {
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+    }
+
+    for (size_t i = 0; i < queue->vptr->capacity(queue); i++) {
+        const size_t count_full = queue->vptr->count(queue);
+        queue->vptr->dequeue_default(queue, nullptr);
+        ASSERT_EQ(queue->vptr->count(queue), count_full - 1);
+
+        queue->vptr->enqueue_default(queue, &element, sizeof(element));
+        ASSERT_EQ(queue->vptr->count(queue), count_full);
+    }
+}
+
+TEST(sequenced_fifo_buffer_wait_test, it_rejects_blocking_operations_without_wait_points)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 4, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const TestClass element(1);
+    TestClass dequeued(0);
+    ASSERT_FALSE(lockfree_fifo_buffer_enqueue_wait(queue, &element, sizeof(element), default_copy));
+    ASSERT_FALSE(lockfree_fifo_buffer_dequeue_wait(queue, &dequeued, default_copy));
+    lockfree_fifo_buffer_close(queue);
+    ASSERT_FALSE(lockfree_fifo_buffer_is_closed(queue));
+
+    // the ring itself is untouched
+    ASSERT_TRUE(queue->vptr->is_empty(queue));
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, &element, sizeof(element)));
+    ASSERT_TRUE(queue->vptr->dequeue_default(queue, &dequeued));
+    ASSERT_EQ(dequeued, element);
+
+    queue->vptr->free(queue);
+}
+
+TEST(sequenced_fifo_buffer_contensivity_test, it_never_contensive_when_single_reader_and_single_writer)
+{
+    constexpr std::size_t required_capacity = 2048;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), required_capacity, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    const size_t tail = 65536 * 16;
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        for (size_t i = 0; i < tail; i++) {
+            TestClass element(0);
+            while (!queue->vptr->dequeue_default(queue, &element)) {
+                // block until successfully dequeued
+            }
+            ASSERT_EQ(element.dummy(), i);
+        }
+    });
+    auto producer = std::async(std::launch::async, [queue] () {
+        for (size_t i = 0; i < tail; i++) {
+            TestClass element(i);
+            while (!queue->vptr->enqueue_default(queue, &element, sizeof(element))) {
+                // block until successfully enqueued
+            }
+        }
+    });
+
+    producer.wait();
+    consumer.wait();
+}
+
+TEST(sequenced_fifo_buffer_contensivity_test, it_never_loses_elements_when_single_reader_and_multiple_writers)
+{
+    constexpr std::size_t writers = 16;
+    constexpr std::size_t tail = 16384;
+    auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(multiwriter_fifo_buffer_new_with_strategy(sizeof(TestClass), 1024, MULTIWRITER_FIFO_BUFFER_LOCKFREE));
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        std::vector<size_t> expected(writers, 0);
+        for (size_t i = 0; i < writers * tail; i++) {
+            TestClass element(0);
+            while (!queue->vptr->dequeue_default((fifo_buffer *)queue, &element)) {
+                // block until successfully dequeued
+            }
+            const size_t writer = element.dummy() / tail;
+            ASSERT_EQ(element.dummy() % tail, expected.at(writer));
+            expected.at(writer) += 1;
+        }
+        ASSERT_TRUE(queue->vptr->is_empty((fifo_buffer *)queue));
+    });
+    std::vector<std::future<void>> producers;
+    for (size_t w = 0; w < writers; w++) {
+        producers.push_back(std::async(std::launch::async, [queue, w] () {
+            for (size_t i = 0; i < tail; i++) {
+                const TestClass element(w * tail + i);
+                if (w % 2 == 0) {
+                    while (!queue->vptr->enqueue_default((fifo_buffer *)queue, &element, sizeof(element))) {
+                        // block until successfully enqueued
+                    }
+                } else {
+                    while (!queue->vptr->try_enqueue_default((fifo_buffer *)queue, &element, sizeof(element))) {
+                        // block until successfully enqueued
+                    }
+                }
+            }
+        }));
+    }
+
+    for (auto &producer: producers) {
+        producer.wait();
+    }
+    consumer.wait();
+}
@@ -0,0 +1,174 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "fifo_buffer_stats.h"
+#include "sharded_fifo_buffer.h"
+}
+
+TEST(sharded_fifo_buffer_initialize_test, it_has_a_shard_per_producer_and_a_shared_one)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(sharded_fifo_buffer_new(sizeof(size_t), 16, 3));
+
+    ASSERT_NE(queue, nullptr);
+    ASSERT_EQ(queue->vptr->capacity(queue), 16 * 4);
+    ASSERT_TRUE(queue->vptr->is_empty(queue));
+
+    queue->vptr->free(queue);
+}
+
+TEST(sharded_fifo_buffer_register_test, it_registers_up_to_max_producers)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(sharded_fifo_buffer_new(sizeof(size_t), 16, 2));
+
+    auto const first = sharded_fifo_buffer_register(queue);
+    auto const second = sharded_fifo_buffer_register(queue);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    ASSERT_NE(first, second);
+    ASSERT_EQ(sharded_fifo_buffer_register(queue), nullptr);
+
+    queue->vptr->free(queue);
+}
+
+TEST(sharded_fifo_buffer_register_test, it_delivers_elements_of_unregistered_producers_before_reusing_their_shard)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(sharded_fifo_buffer_new(sizeof(size_t), 16, 1));
+
+    auto const producer = sharded_fifo_buffer_register(queue);
+    for (size_t i = 0; i < 3; i++) {
+        ASSERT_TRUE(producer->vptr->enqueue_default(producer, &i, sizeof(i)));
+    }
+    sharded_fifo_buffer_unregister(queue, producer);
+    ASSERT_EQ(sharded_fifo_buffer_register(queue), nullptr);
+
+    for (size_t i = 0; i < 3; i++) {
+        size_t element = SIZE_MAX;
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, &element));
+        ASSERT_EQ(element, i);
+    }
+    ASSERT_FALSE(queue->vptr->dequeue_default(queue, nullptr));
+    ASSERT_NE(sharded_fifo_buffer_register(queue), nullptr);
+
+    queue->vptr->free(queue);
+}
+
+TEST(sharded_fifo_buffer_dequeue_test, it_drains_shards_round_robin)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(sharded_fifo_buffer_new(sizeof(size_t), 16, 2));
+    auto const first = sharded_fifo_buffer_register(queue);
+    auto const second = sharded_fifo_buffer_register(queue);
+
+    for (size_t i = 0; i < 3; i++) {
+        const size_t a = 100 + i;
+        const size_t b = 200 + i;
+        first->vptr->enqueue_default(first, &a, sizeof(a));
+        second->vptr->enqueue_default(second, &b, sizeof(b));
+    }
+    const size_t shared = 300;
+    queue->vptr->enqueue_default(queue, &shared, sizeof(shared));
+    ASSERT_EQ(queue->vptr->count(queue), 7);
+
+    std::vector<size_t> dequeues;
+    size_t element = 0;
+    ASSERT_EQ(*reinterpret_cast<const size_t *>(queue->vptr->peek(queue)), 300);
+    while (queue->vptr->dequeue_default(queue, &element)) {
+        dequeues.push_back(element);
+    }
+    ASSERT_EQ(dequeues, (std::vector<size_t> { 300, 100, 200, 101, 201, 102, 202 }));
+
+    queue->vptr->free(queue);
+}
+
+TEST(sharded_fifo_buffer_dequeue_test, it_drains_weighted_shards_in_proportion)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(sharded_fifo_buffer_new(sizeof(size_t), 16, 2));
+    auto const heavy = sharded_fifo_buffer_register_weighted(queue, 3);
+    auto const light = sharded_fifo_buffer_register(queue);
+
+    for (size_t i = 0; i < 6; i++) {
+        const size_t a = 100 + i;
+        const size_t b = 200 + i;
+        heavy->vptr->enqueue_default(heavy, &a, sizeof(a));
+        light->vptr->enqueue_default(light, &b, sizeof(b));
+    }
+
+    std::vector<size_t> dequeues(8);
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeues.data(), sizeof(size_t), dequeues.size(), memcpy), dequeues.size());
+    ASSERT_EQ(dequeues, (std::vector<size_t> { 100, 101, 102, 200, 103, 104, 105, 201 }));
+
+    queue->vptr->free(queue);
+}
+
+TEST(sharded_fifo_buffer_concurrent_test, it_preserves_order_of_each_producer)
+{
+    constexpr size_t producers = 4;
+    constexpr size_t per_producer = 50000;
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(sharded_fifo_buffer_new(sizeof(std::pair<size_t, size_t>), 64, producers));
+
+    std::vector<std::future<void>> tasks;
+    for (size_t producer = 0; producer < producers; producer++) {
+        tasks.push_back(std::async(std::launch::async, [queue, producer] () {
+            auto const handle = sharded_fifo_buffer_register(queue);
+            ASSERT_NE(handle, nullptr);
+            for (size_t i = 0; i < per_producer; i++) {
+                const std::pair<size_t, size_t> element(producer, i);
+                while (!handle->vptr->enqueue_default(handle, &element, sizeof(element))) {
+                    std::this_thread::yield();
+                }
+            }
+            sharded_fifo_buffer_unregister(queue, handle);
+        }));
+    }
+
+    std::vector<size_t> expected(producers, 0);
+    std::vector<std::pair<size_t, size_t>> elements(32);
+    for (size_t received = 0; received < producers * per_producer;) {
+        const size_t dequeued = queue->vptr->dequeue_bulk(queue, elements.data(), sizeof(elements.at(0)), elements.size(), memcpy);
+        if (dequeued == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < dequeued; i++) {
+            ASSERT_EQ(elements.at(i).second, expected.at(elements.at(i).first));
+            expected.at(elements.at(i).first)++;
+        }
+        received += dequeued;
+    }
+    for (auto &task: tasks) {
+        task.wait();
+    }
+    ASSERT_TRUE(queue->vptr->is_empty(queue));
+
+    queue->vptr->free(queue);
+}
+
+#if defined(FIFO_BUFFER_STATS)
+TEST(sharded_fifo_buffer_stats_test, it_sums_the_shards)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(sharded_fifo_buffer_new(sizeof(size_t), 4, 2));
+    auto const first = sharded_fifo_buffer_register(queue);
+    auto const second = sharded_fifo_buffer_register(queue);
+
+    for (size_t i = 0; i < 3; i++) {
+        first->vptr->enqueue_default(first, &i, sizeof(i));
+        second->vptr->enqueue_default(second, &i, sizeof(i));
+    }
+    while (queue->vptr->dequeue_default(queue, nullptr)) {
+    }
+
+    struct fifo_buffer_stats stats {};
+    ASSERT_TRUE(queue->vptr->stats_snapshot(queue, &stats));
+    ASSERT_EQ(stats.enqueued, 6);
+    ASSERT_EQ(stats.dequeued, 6);
+    ASSERT_EQ(stats.empty_polls, 1);
+    ASSERT_EQ(stats.high_water_mark, 3);
+
+    queue->vptr->free(queue);
+}
+#endif
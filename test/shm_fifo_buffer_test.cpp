@@ -0,0 +1,236 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern "C" {
+#include "shm_fifo_buffer.h"
+
+void shm_fifo_buffer_test_lock_producer(struct fifo_buffer *self);
+void shm_fifo_buffer_test_corrupt_geometry(struct fifo_buffer *self);
+}
+
+static std::string unique_name()
+{
+    return "/lockfree_queue_test." + std::to_string(getpid()) + "." +
+           ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// runs body in a child process and returns its exit status
+template<typename Body>
+static int run_child(Body body)
+{
+    const pid_t pid = fork();
+    if (pid == 0) {
+        _exit(body());
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+TEST(shm_fifo_buffer_initialize_test, it_is_creatable_and_attachable_by_name)
+{
+    const auto name = unique_name();
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_create(name.c_str(), sizeof(size_t), 14, SHM_FIFO_BUFFER_SINGLE_WRITER));
+    ASSERT_NE(queue, nullptr);
+    ASSERT_EQ(shm_fifo_buffer_create(name.c_str(), sizeof(size_t), 14, SHM_FIFO_BUFFER_SINGLE_WRITER), nullptr);
+
+    auto const attached = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_attach(name.c_str()));
+    ASSERT_NE(attached, nullptr);
+    ASSERT_EQ(attached->vptr->capacity(attached), queue->vptr->capacity(queue));
+    ASSERT_EQ(shm_fifo_buffer_get_mode(attached), SHM_FIFO_BUFFER_SINGLE_WRITER);
+
+    ASSERT_TRUE(shm_fifo_buffer_unlink(name.c_str()));
+    ASSERT_EQ(shm_fifo_buffer_attach(name.c_str()), nullptr);
+    queue->vptr->free(queue);
+    attached->vptr->free(attached);
+}
+
+TEST(shm_fifo_buffer_initialize_test, it_rejects_regions_it_did_not_format)
+{
+    const auto name = unique_name();
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_create(name.c_str(), sizeof(size_t), 14, SHM_FIFO_BUFFER_SINGLE_WRITER));
+    ASSERT_NE(queue, nullptr);
+    shm_fifo_buffer_unlink(name.c_str());
+
+    ASSERT_EQ(ftruncate(shm_fifo_buffer_fd(queue), 4096), 0);
+    ASSERT_EQ(shm_fifo_buffer_attach_fd(shm_fifo_buffer_fd(queue)), nullptr);
+    queue->vptr->free(queue);
+}
+
+TEST(shm_fifo_buffer_enqueue_test, it_transfers_elements_between_mappings_at_different_addresses)
+{
+    auto const producer = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_create_anonymous(sizeof(size_t), 14, SHM_FIFO_BUFFER_SINGLE_WRITER));
+    ASSERT_NE(producer, nullptr);
+    auto const consumer = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_attach_fd(shm_fifo_buffer_fd(producer)));
+    ASSERT_NE(consumer, nullptr);
+
+    size_t enqueued = 0;
+    while (producer->vptr->enqueue_default(producer, &enqueued, sizeof(enqueued))) {
+        enqueued++;
+    }
+    ASSERT_EQ(enqueued, producer->vptr->capacity(producer));
+    ASSERT_TRUE(consumer->vptr->is_full(consumer));
+
+    ASSERT_EQ(consumer->vptr->peek_size(consumer), sizeof(size_t));
+    for (size_t i = 0; i < enqueued; i++) {
+        size_t element = SIZE_MAX;
+        ASSERT_TRUE(consumer->vptr->dequeue_default(consumer, &element));
+        ASSERT_EQ(element, i);
+    }
+    ASSERT_TRUE(producer->vptr->is_empty(producer));
+
+    producer->vptr->free(producer);
+    consumer->vptr->free(consumer);
+}
+
+TEST(shm_fifo_buffer_enqueue_test, it_transfers_in_bulk_and_zero_copy)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_create_anonymous(sizeof(size_t), 14, SHM_FIFO_BUFFER_SINGLE_WRITER));
+    ASSERT_NE(queue, nullptr);
+
+    const size_t elements[] = { 1, 2, 3 };
+    ASSERT_EQ(queue->vptr->enqueue_bulk(queue, elements, sizeof(size_t), 3, memcpy), 3);
+
+    auto const reserved = static_cast<size_t *>(shm_fifo_buffer_reserve(queue));
+    ASSERT_NE(reserved, nullptr);
+    *reserved = 4;
+    shm_fifo_buffer_commit(queue, sizeof(size_t));
+
+    size_t dequeued[2] = {};
+    ASSERT_EQ(queue->vptr->dequeue_bulk(queue, dequeued, sizeof(size_t), 2, memcpy), 2);
+    ASSERT_EQ(dequeued[0], 1);
+    ASSERT_EQ(dequeued[1], 2);
+
+    for (const size_t expected: { 3, 4 }) {
+        size_t size = 0;
+        auto const head = static_cast<const size_t *>(shm_fifo_buffer_acquire(queue, &size));
+        ASSERT_NE(head, nullptr);
+        ASSERT_EQ(size, sizeof(size_t));
+        ASSERT_EQ(*head, expected);
+        shm_fifo_buffer_release(queue);
+    }
+    ASSERT_EQ(shm_fifo_buffer_acquire(queue, nullptr), nullptr);
+    queue->vptr->free(queue);
+}
+
+TEST(shm_fifo_buffer_enqueue_test, it_keeps_the_geometry_it_validated_when_a_peer_rewrites_the_header)
+{
+    auto const producer = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_create_anonymous(sizeof(size_t), 4, SHM_FIFO_BUFFER_SINGLE_WRITER));
+    ASSERT_NE(producer, nullptr);
+    auto const consumer = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_attach_fd(shm_fifo_buffer_fd(producer)));
+    ASSERT_NE(consumer, nullptr);
+
+    const size_t elements[] = { 1, 2, 3 };
+    ASSERT_EQ(producer->vptr->enqueue_bulk(producer, elements, sizeof(size_t), 3, memcpy), 3);
+    shm_fifo_buffer_test_corrupt_geometry(producer);
+
+    ASSERT_EQ(consumer->vptr->capacity(consumer), 4);
+    ASSERT_EQ(consumer->vptr->peek_size(consumer), sizeof(size_t));
+
+    size_t element[2] = { SIZE_MAX, SIZE_MAX };
+    ASSERT_TRUE(consumer->vptr->dequeue_default(consumer, element));
+    ASSERT_EQ(element[0], 1);
+    ASSERT_EQ(element[1], SIZE_MAX);
+
+    size_t dequeued[2] = {};
+    ASSERT_EQ(consumer->vptr->dequeue_bulk(consumer, dequeued, sizeof(size_t), 2, memcpy), 2);
+    ASSERT_EQ(dequeued[0], 2);
+    ASSERT_EQ(dequeued[1], 3);
+
+    producer->vptr->free(producer);
+    consumer->vptr->free(consumer);
+}
+
+TEST(shm_fifo_buffer_contensivity_test, it_never_contensive_when_producer_is_another_process)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(shm_fifo_buffer_create_anonymous(sizeof(size_t), 63, SHM_FIFO_BUFFER_SINGLE_WRITER));
+    ASSERT_NE(queue, nullptr);
+    constexpr size_t total = 100000;
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+        for (size_t i = 0; i < total; i++) {
+            while (!queue->vptr->enqueue_default(queue, &i, sizeof(i))) {
+                sched_yield();
+            }
+        }
+        _exit(0);
+    }
+
+    for (size_t i = 0; i < total; i++) {
+        size_t element = SIZE_MAX;
+        while (!queue->vptr->dequeue_default(queue, &element)) {
+            sched_yield();
+        }
+        ASSERT_EQ(element, i);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    queue->vptr->free(queue);
+}
+
+TEST(shm_fifo_buffer_contensivity_test, it_preserves_order_of_each_writer_when_multiple_writer_processes)
+{
+    auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(shm_fifo_buffer_create_anonymous(2 * sizeof(size_t), 63, SHM_FIFO_BUFFER_MULTIWRITER));
+    ASSERT_NE(queue, nullptr);
+    auto const base = reinterpret_cast<struct fifo_buffer *>(queue);
+    constexpr size_t writers = 4;
+    constexpr size_t per_writer = 10000;
+
+    std::vector<pid_t> children;
+    for (size_t writer = 0; writer < writers; writer++) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            for (size_t i = 0; i < per_writer; i++) {
+                const size_t element[2] = { writer, i };
+                while (!queue->vptr->enqueue_default(base, element, sizeof(element))) {
+                    sched_yield();
+                }
+            }
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+
+    std::vector<size_t> expected(writers, 0);
+    for (size_t received = 0; received < writers * per_writer; received++) {
+        size_t element[2] = {};
+        while (!queue->vptr->dequeue_default(base, element)) {
+            sched_yield();
+        }
+        ASSERT_EQ(element[1], expected.at(element[0]));
+        expected.at(element[0])++;
+    }
+    for (const pid_t pid: children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+    base->vptr->free(base);
+}
+
+TEST(shm_fifo_buffer_contensivity_test, it_recovers_when_a_writer_process_dies_holding_the_lock)
+{
+    auto const queue = reinterpret_cast<struct multiwriter_fifo_buffer *>(shm_fifo_buffer_create_anonymous(sizeof(size_t), 14, SHM_FIFO_BUFFER_MULTIWRITER));
+    ASSERT_NE(queue, nullptr);
+    auto const base = reinterpret_cast<struct fifo_buffer *>(queue);
+
+    ASSERT_EQ(run_child([base] () {
+        shm_fifo_buffer_test_lock_producer(base);
+        return 0;
+    }), 0);
+
+    const size_t element = 42;
+    ASSERT_TRUE(queue->vptr->try_enqueue_default(base, &element, sizeof(element)));
+    ASSERT_TRUE(queue->vptr->enqueue_default(base, &element, sizeof(element)));
+    ASSERT_EQ(base->vptr->count(base), 2);
+    base->vptr->free(base);
+}
@@ -0,0 +1,24 @@
+// Reaches into the shared header, which needs C11 atomics, to simulate a producer
+// process that dies in the middle of an enqueue or scribbles over the region.
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "shm_fifo_buffer_internal.h"
+
+void shm_fifo_buffer_test_lock_producer(struct fifo_buffer *const self)
+{
+    pthread_mutex_lock(&((struct shm_fifo_buffer *)self)->header->mutex);
+}
+
+void shm_fifo_buffer_test_corrupt_geometry(struct fifo_buffer *const self)
+{
+    struct shm_fifo_buffer_header *const header = ((struct shm_fifo_buffer *)self)->header;
+    header->capacity = UINT64_C(1) << 40;
+    header->element_size = UINT64_MAX;
+    header->element_stride = UINT64_C(1) << 20;
+
+    const size_t read_index = atomic_load_explicit(&header->read_index, memory_order_relaxed);
+    shm_fifo_buffer_element_at((struct shm_fifo_buffer *)self, read_index)->size = SIZE_MAX;
+}
@@ -0,0 +1,244 @@
+#include <memory>
+#include <future>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+extern "C" {
+#include "stream_fifo_buffer.h"
+}
+
+static std::vector<uint8_t> make_message(std::size_t seed)
+{
+    // sizes cycle through 0..300 bytes so that records straddle the arena end at varying offsets
+    std::vector<uint8_t> message(seed * 37 % 301);
+    std::iota(message.begin(), message.end(), static_cast<uint8_t>(seed));
+    return message;
+}
+
+TEST(stream_fifo_buffer_initialize_test, it_is_initializable)
+{
+    auto const queue = reinterpret_cast<fifo_buffer *>(stream_fifo_buffer_new(4096));
+
+    ASSERT_NE(queue, nullptr);
+
+    queue->vptr->free(queue);
+}
+
+TEST(stream_fifo_buffer_initialize_test, it_has_enough_capacity)
+{
+    for (size_t i = 0; i < 65535; i += 1023) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(i));
+        ASSERT_GE(queue->vptr->capacity(queue), i);
+        queue->vptr->free(queue);
+    }
+}
+
+TEST(stream_fifo_buffer_initialize_test, it_is_empty_after_initialization)
+{
+    for (size_t i = 0; i < 4096; i += 64) {
+        auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(i));
+        ASSERT_TRUE(queue->vptr->is_empty(queue));
+        ASSERT_FALSE(queue->vptr->is_full(queue));
+        ASSERT_EQ(queue->vptr->count(queue), 0);
+        queue->vptr->free(queue);
+    }
+}
+
+TEST(stream_fifo_buffer_enqueue_default_test, it_enqueues_messages_of_different_sizes)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(4096));
+
+    const std::vector<uint8_t> small(40, 0x11);
+    const std::vector<uint8_t> large(1000, 0x22);
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, small.data(), small.size()));
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, large.data(), large.size()));
+
+    ASSERT_EQ(queue->vptr->count(queue), 2);
+    ASSERT_EQ(queue->vptr->peek_size(queue), small.size());
+}
+
+TEST(stream_fifo_buffer_enqueue_default_test, it_cannot_enqueue_message_larger_than_arena)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(4096));
+
+    const std::vector<uint8_t> message(queue->vptr->capacity(queue), 0x33);
+    ASSERT_FALSE(queue->vptr->enqueue_default(queue, message.data(), message.size()));
+    ASSERT_TRUE(queue->vptr->is_empty(queue));
+}
+
+TEST(stream_fifo_buffer_enqueue_default_test, it_cannot_enqueue_message_larger_than_half_the_arena)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(128));
+
+    const std::vector<uint8_t> message(96, 0x33);
+    ASSERT_FALSE(queue->vptr->enqueue_default(queue, message.data(), message.size()));
+    ASSERT_TRUE(queue->vptr->is_empty(queue));
+
+    queue->vptr->free(queue);
+}
+
+TEST(stream_fifo_buffer_enqueue_default_test, it_always_enqueues_largest_message_into_drained_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(128));
+
+    // the largest accepted record, wherever the previous records left the write position
+    std::vector<uint8_t> largest(queue->vptr->capacity(queue) / 2, 0x55);
+    while (!queue->vptr->enqueue_default(queue, largest.data(), largest.size())) {
+        ASSERT_FALSE(largest.empty());
+        largest.pop_back();
+    }
+    ASSERT_TRUE(queue->vptr->dequeue_default(queue, nullptr));
+
+    for (size_t filler = 0; filler <= largest.size(); filler++) {
+        const std::vector<uint8_t> message(filler, 0x66);
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, message.data(), message.size()));
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, nullptr));
+
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, largest.data(), largest.size()));
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, nullptr));
+        ASSERT_TRUE(queue->vptr->is_empty(queue));
+    }
+
+    queue->vptr->free(queue);
+}
+
+TEST(stream_fifo_buffer_enqueue_default_test, it_cannot_enqueue_into_full_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(4096));
+
+    const std::vector<uint8_t> message(40, 0x44);
+    while (queue->vptr->enqueue_default(queue, message.data(), message.size())) {
+        // do nothing
+    }
+
+    ASSERT_GE(queue->vptr->count(queue) * message.size(), queue->vptr->capacity(queue) / 2);
+    ASSERT_FALSE(queue->vptr->enqueue_default(queue, message.data(), message.size()));
+
+    queue->vptr->dequeue_default(queue, nullptr);
+    ASSERT_TRUE(queue->vptr->enqueue_default(queue, message.data(), message.size()));
+}
+
+TEST(stream_fifo_buffer_enqueue_default_test, it_becomes_full_when_not_even_an_empty_message_fits)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(4096));
+
+    const uint8_t empty = 0;
+    while (queue->vptr->enqueue_default(queue, &empty, 0)) {
+        // do nothing
+    }
+
+    ASSERT_TRUE(queue->vptr->is_full(queue));
+}
+
+TEST(stream_fifo_buffer_dequeue_default_test, it_cannot_dequeue_from_empty_queue)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(4096));
+
+    ASSERT_FALSE(queue->vptr->dequeue_default(queue, nullptr));
+}
+
+TEST(stream_fifo_buffer_dequeue_default_test, it_dequeues_messages_order_by_first_in_first_out_across_wrap_around)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(1024));
+
+    size_t enqueued = 0;
+    size_t dequeued = 0;
+    while (dequeued < 65535) {
+        for (auto message = make_message(enqueued); queue->vptr->enqueue_default(queue, message.data(), message.size()); message = make_message(enqueued)) {
+            enqueued++;
+        }
+        for (size_t i = 0; i < 3 && !queue->vptr->is_empty(queue); i++) {
+            const auto expected = make_message(dequeued++);
+            ASSERT_EQ(queue->vptr->peek_size(queue), expected.size());
+
+            std::vector<uint8_t> message(expected.size());
+            ASSERT_TRUE(queue->vptr->dequeue_default(queue, message.data()));
+            ASSERT_EQ(message, expected);
+        }
+    }
+}
+
+TEST(stream_fifo_buffer_peek_test, it_peaks_message_which_is_dequeued_next)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(1024));
+
+    for (size_t i = 0; i < 4096; i++) {
+        const auto message = make_message(i);
+        ASSERT_TRUE(queue->vptr->enqueue_default(queue, message.data(), message.size()));
+
+        const auto *const peeked = reinterpret_cast<const uint8_t *>(queue->vptr->peek(queue));
+        ASSERT_EQ(std::vector<uint8_t>(peeked, peeked + queue->vptr->peek_size(queue)), message);
+        ASSERT_TRUE(queue->vptr->dequeue_default(queue, nullptr));
+    }
+}
+
+TEST(stream_fifo_buffer_count_test, it_counts_messages_rather_than_bytes)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(4096));
+
+    size_t previous = queue->vptr->count(queue);
+    for (size_t i = 0; queue->vptr->enqueue_default(queue, make_message(i).data(), make_message(i).size()); i++) {
+        const size_t current = queue->vptr->count(queue);
+        ASSERT_EQ(current, previous + 1);
+        previous = current;
+    }
+    while (queue->vptr->dequeue_default(queue, nullptr)) {
+        const size_t current = queue->vptr->count(queue);
+        ASSERT_EQ(current, previous - 1);
+        previous = current;
+    }
+}
+
+TEST(stream_fifo_buffer_bulk_test, it_transfers_messages_in_bulk)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(1024));
+
+    std::vector<uint64_t> elements(4096);
+    std::iota(elements.begin(), elements.end(), 0);
+    std::vector<uint64_t> dequeues;
+
+    size_t enqueued = 0;
+    while (dequeues.size() != elements.size()) {
+        enqueued += queue->vptr->enqueue_bulk(queue, elements.data() + enqueued, sizeof(uint64_t), std::min<size_t>(elements.size() - enqueued, 50), memcpy);
+
+        std::vector<uint64_t> buffer(7);
+        const size_t dequeued = queue->vptr->dequeue_bulk(queue, buffer.data(), sizeof(uint64_t), buffer.size(), memcpy);
+        dequeues.insert(dequeues.end(), buffer.begin(), buffer.begin() + dequeued);
+    }
+
+    ASSERT_EQ(dequeues, elements);
+}
+
+TEST(stream_fifo_buffer_contensivity_test, it_never_contensive_when_single_reader_and_single_writer)
+{
+    auto const queue = reinterpret_cast<struct fifo_buffer *>(stream_fifo_buffer_new(16384));
+
+    const size_t tail = 65536 * 4;
+
+    auto consumer = std::async(std::launch::async, [queue] () {
+        std::vector<uint8_t> message(512);
+        for (size_t i = 0; i < tail; i++) {
+            while (queue->vptr->is_empty(queue)) {
+                // block until a message arrives
+            }
+            const auto expected = make_message(i);
+            ASSERT_EQ(queue->vptr->peek_size(queue), expected.size());
+            ASSERT_TRUE(queue->vptr->dequeue_default(queue, message.data()));
+            ASSERT_TRUE(std::equal(expected.begin(), expected.end(), message.begin()));
+        }
+    });
+    auto producer = std::async(std::launch::async, [queue] () {
+        for (size_t i = 0; i < tail; i++) {
+            const auto message = make_message(i);
+            while (!queue->vptr->enqueue_default(queue, message.data(), message.size())) {
+                // block until successfully enqueued
+            }
+        }
+    });
+
+    producer.wait();
+    consumer.wait();
+}